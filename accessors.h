@@ -0,0 +1,776 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace std {
+    // A data handle that remembers an element index next to the storage pointer, for accessors whose elements
+    // don't sit at whole storage positions (bit-packed) or whose decoding depends on the position (grouped scales).
+    template <class _Storage>
+    struct indexed_pointer {
+        _Storage* data = nullptr;
+        size_t index = 0;
+
+        constexpr indexed_pointer() noexcept = default;
+
+        constexpr indexed_pointer(_Storage* _Data, const size_t _Index = 0) noexcept : data(_Data), index(_Index) {}
+
+        template <class _OtherStorage, enable_if_t<is_convertible_v<_OtherStorage*, _Storage*>, int> = 0>
+        constexpr indexed_pointer(const indexed_pointer<_OtherStorage>& _Other) noexcept
+            : data(_Other.data), index(_Other.index) {}
+
+        _NODISCARD friend constexpr bool operator==(const indexed_pointer&, const indexed_pointer&) noexcept = default;
+    };
+
+    // The reference type of the accessors below for mutable elements: reads decode through the accessor and writes
+    // encode through it.
+    template <class _Accessor>
+    class _Proxy_reference {
+    public:
+        using value_type = typename _Accessor::value_type;
+        using pointer = typename _Accessor::pointer;
+
+        constexpr _Proxy_reference(const _Accessor& _Acc_, const pointer& _Ptr_, const size_t _Idx_) noexcept
+            : _Acc(_Acc_), _Ptr(_Ptr_), _Idx(_Idx_) {}
+
+        _Proxy_reference(const _Proxy_reference&) = default;
+
+        constexpr operator value_type() const {
+            return _Acc._Load(_Ptr, _Idx);
+        }
+
+        constexpr const _Proxy_reference& operator=(const value_type& _Val) const {
+            _Acc._Store(_Ptr, _Idx, _Val);
+            return *this;
+        }
+
+        constexpr const _Proxy_reference& operator=(const _Proxy_reference& _Other) const {
+            return *this = static_cast<value_type>(_Other);
+        }
+
+        template <class _Ty>
+        constexpr const _Proxy_reference& operator+=(const _Ty& _Val) const {
+            return *this = static_cast<value_type>(static_cast<value_type>(*this) + _Val);
+        }
+
+        template <class _Ty>
+        constexpr const _Proxy_reference& operator-=(const _Ty& _Val) const {
+            return *this = static_cast<value_type>(static_cast<value_type>(*this) - _Val);
+        }
+
+        template <class _Ty>
+        constexpr const _Proxy_reference& operator*=(const _Ty& _Val) const {
+            return *this = static_cast<value_type>(static_cast<value_type>(*this) * _Val);
+        }
+
+        template <class _Ty>
+        constexpr const _Proxy_reference& operator/=(const _Ty& _Val) const {
+            return *this = static_cast<value_type>(static_cast<value_type>(*this) / _Val);
+        }
+
+    private:
+        _Accessor _Acc;
+        pointer _Ptr;
+        size_t _Idx;
+    };
+
+    // IEEE 754 binary16, rounded to nearest even.
+    struct float16_codec {
+        using storage_type = uint16_t;
+        using value_type = float;
+
+        _NODISCARD static constexpr float decode(const uint16_t _Half) noexcept {
+            const uint32_t _Sign = static_cast<uint32_t>(_Half & 0x8000u) << 16;
+            const uint32_t _Exp = (_Half >> 10) & 0x1Fu;
+            const uint32_t _Mant = _Half & 0x3FFu;
+            if (_Exp == 0x1F) {
+                return _STD bit_cast<float>(_Sign | 0x7F80'0000u | (_Mant << 13));
+            }
+
+            if (_Exp == 0) {
+                // Zero or subnormal: _Mant * 2^-24 is exact in float.
+                const float _Magnitude = static_cast<float>(_Mant) * 0x1p-24f;
+                return _Sign ? -_Magnitude : _Magnitude;
+            }
+
+            return _STD bit_cast<float>(_Sign | ((_Exp + 112) << 23) | (_Mant << 13));
+        }
+
+        _NODISCARD static constexpr uint16_t encode(const float _Val) noexcept {
+            const uint32_t _Bits = _STD bit_cast<uint32_t>(_Val);
+            const uint32_t _Sign = (_Bits >> 16) & 0x8000u;
+            const uint32_t _Exp = (_Bits >> 23) & 0xFFu;
+            uint32_t _Mant = _Bits & 0x7F'FFFFu;
+            if (_Exp == 0xFF) {
+                return static_cast<uint16_t>(_Sign | 0x7C00u | (_Mant ? 0x200u | (_Mant >> 13) : 0u));
+            }
+
+            const int _Half_exp = static_cast<int>(_Exp) - 127 + 15;
+            if (_Half_exp >= 0x1F) {
+                return static_cast<uint16_t>(_Sign | 0x7C00u);
+            }
+
+            if (_Half_exp <= 0) {
+                if (_Half_exp < -10) {
+                    return static_cast<uint16_t>(_Sign);
+                }
+
+                _Mant |= 0x80'0000u;
+                const auto _Shift = static_cast<uint32_t>(14 - _Half_exp);
+                uint32_t _Result = _Mant >> _Shift;
+                const uint32_t _Rest = _Mant & ((1u << _Shift) - 1);
+                const uint32_t _Halfway = 1u << (_Shift - 1);
+                if (_Rest > _Halfway || (_Rest == _Halfway && (_Result & 1))) {
+                    ++_Result;
+                }
+                return static_cast<uint16_t>(_Sign | _Result);
+            }
+
+            // A carry out of the mantissa correctly bumps the exponent, up to infinity.
+            uint32_t _Result = (static_cast<uint32_t>(_Half_exp) << 10) | (_Mant >> 13);
+            const uint32_t _Rest = _Mant & 0x1FFFu;
+            if (_Rest > 0x1000u || (_Rest == 0x1000u && (_Result & 1))) {
+                ++_Result;
+            }
+            return static_cast<uint16_t>(_Sign | _Result);
+        }
+    };
+
+    // The upper half of an IEEE 754 binary32, rounded to nearest even.
+    struct bfloat16_codec {
+        using storage_type = uint16_t;
+        using value_type = float;
+
+        _NODISCARD static constexpr float decode(const uint16_t _Half) noexcept {
+            return _STD bit_cast<float>(static_cast<uint32_t>(_Half) << 16);
+        }
+
+        _NODISCARD static constexpr uint16_t encode(const float _Val) noexcept {
+            const uint32_t _Bits = _STD bit_cast<uint32_t>(_Val);
+            if ((_Bits & 0x7FFF'FFFFu) > 0x7F80'0000u) {
+                // Keep NaNs quiet; rounding could turn one into infinity.
+                return static_cast<uint16_t>((_Bits >> 16) | 0x40u);
+            }
+            return static_cast<uint16_t>((_Bits + 0x7FFFu + ((_Bits >> 16) & 1)) >> 16);
+        }
+    };
+
+    // Stores each element as _Codec::storage_type and exposes it as _Codec::value_type. _Codec provides
+    // storage_type, value_type, and static decode and encode functions.
+    template <class _ElementType, class _Codec>
+    class encoded_accessor {
+    public:
+        static_assert(is_same_v<remove_cv_t<_ElementType>, typename _Codec::value_type>,
+            "The element type must be the codec's value type.");
+
+        using offset_policy = encoded_accessor;
+        using element_type = _ElementType;
+        using value_type = typename _Codec::value_type;
+        using storage_type = typename _Codec::storage_type;
+        using pointer = conditional_t<is_const_v<_ElementType>, const storage_type*, storage_type*>;
+        using reference = conditional_t<is_const_v<_ElementType>, value_type, _Proxy_reference<encoded_accessor>>;
+
+        constexpr encoded_accessor() noexcept = default;
+
+        template <class _OtherElementType,
+            enable_if_t<is_convertible_v<_OtherElementType (*)[], _ElementType (*)[]>, int> = 0>
+        constexpr encoded_accessor(encoded_accessor<_OtherElementType, _Codec>) noexcept {}
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const noexcept {
+            return _Ptr + _Idx;
+        }
+
+        _NODISCARD constexpr reference access(pointer _Ptr, size_t _Idx) const noexcept {
+            if constexpr (is_const_v<_ElementType>) {
+                return _Load(_Ptr, _Idx);
+            } else {
+                return reference{*this, _Ptr, _Idx};
+            }
+        }
+
+    private:
+        friend _Proxy_reference<encoded_accessor>;
+
+        _NODISCARD static constexpr value_type _Load(pointer _Ptr, size_t _Idx) noexcept {
+            return _Codec::decode(_Ptr[_Idx]);
+        }
+
+        static constexpr void _Store(pointer _Ptr, size_t _Idx, const value_type& _Val) noexcept {
+            _Ptr[_Idx] = _Codec::encode(_Val);
+        }
+    };
+
+    template <class _ElementType>
+    using float16_accessor = encoded_accessor<_ElementType, float16_codec>;
+
+    template <class _ElementType>
+    using bfloat16_accessor = encoded_accessor<_ElementType, bfloat16_codec>;
+
+    // Stores each element as a _Storage integer q and exposes it as q * scale. The scale is either one value for
+    // the whole tensor or one per group of group_size consecutive offsets, e.g. per row of a layout_right matrix
+    // with group_size = extent(1). Writes round to nearest and saturate; NaN is stored as 0.
+    template <class _ElementType, class _Storage = int8_t>
+    class scaled_accessor {
+    public:
+        static_assert(is_floating_point_v<remove_cv_t<_ElementType>>, "Scaled elements must be floating-point.");
+        static_assert(is_integral_v<_Storage>, "Scaled storage must be an integer type.");
+
+        using offset_policy = scaled_accessor;
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<_ElementType>;
+        using storage_type = _Storage;
+        using pointer = indexed_pointer<conditional_t<is_const_v<_ElementType>, const _Storage, _Storage>>;
+        using reference = conditional_t<is_const_v<_ElementType>, value_type, _Proxy_reference<scaled_accessor>>;
+
+        constexpr scaled_accessor() noexcept = default;
+
+        explicit constexpr scaled_accessor(const value_type _Scale_) noexcept : _Scale(_Scale_) {
+            _STL_VERIFY(_Scale != 0, "Scales must be nonzero.");
+        }
+
+        // The scale array's length isn't known here, so each group's scale is verified when it's stored through.
+        constexpr scaled_accessor(const value_type* _Scales_, const size_t _Group_size_) noexcept
+            : _Scales(_Scales_), _Group_size(_Group_size_) {
+            _STL_VERIFY(_Scales && _Group_size > 0, "Grouped scales need a scale array and a nonzero group size.");
+        }
+
+        template <class _OtherElementType,
+            enable_if_t<is_convertible_v<_OtherElementType (*)[], _ElementType (*)[]>, int> = 0>
+        constexpr scaled_accessor(const scaled_accessor<_OtherElementType, _Storage>& _Other) noexcept
+            : _Scale(_Other._Scale), _Scales(_Other._Scales), _Group_size(_Other._Group_size) {}
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const noexcept {
+            return {_Ptr.data, _Ptr.index + _Idx};
+        }
+
+        _NODISCARD constexpr reference access(pointer _Ptr, size_t _Idx) const noexcept {
+            if constexpr (is_const_v<_ElementType>) {
+                return _Load(_Ptr, _Idx);
+            } else {
+                return reference{*this, _Ptr, _Idx};
+            }
+        }
+
+        _NODISCARD constexpr value_type scale(const size_t _Idx) const noexcept {
+            return _Scales ? _Scales[_Idx / _Group_size] : _Scale;
+        }
+
+    private:
+        template <class, class>
+        friend class scaled_accessor;
+        friend _Proxy_reference<scaled_accessor>;
+
+        _NODISCARD constexpr value_type _Load(pointer _Ptr, size_t _Idx) const noexcept {
+            _Idx += _Ptr.index;
+            return static_cast<value_type>(_Ptr.data[_Idx]) * scale(_Idx);
+        }
+
+        void _Store(pointer _Ptr, size_t _Idx, const value_type& _Val) const noexcept {
+            _Idx += _Ptr.index;
+            constexpr auto _Lo = static_cast<value_type>((numeric_limits<_Storage>::min)());
+            constexpr auto _Hi = static_cast<value_type>((numeric_limits<_Storage>::max)());
+            const value_type _Group_scale = scale(_Idx);
+            _STL_VERIFY(_Group_scale != 0, "Scales must be nonzero.");
+            const value_type _Quantized = _STD round(_Val / _Group_scale);
+            if (_STD isnan(_Quantized)) {
+                _Ptr.data[_Idx] = _Storage{0};
+                return;
+            }
+            _Ptr.data[_Idx] = static_cast<_Storage>((_STD min)((_STD max)(_Quantized, _Lo), _Hi));
+        }
+
+        value_type _Scale = 1;
+        const value_type* _Scales = nullptr;
+        size_t _Group_size = 0;
+    };
+
+    // Stores each element in _Bits bits, packed from the least significant end of each byte. Elements that share
+    // a byte can't be written concurrently.
+    template <class _ElementType, size_t _Bits>
+    class packed_accessor {
+    public:
+        static_assert(_Bits == 1 || _Bits == 2 || _Bits == 4, "Packed elements must be 1, 2, or 4 bits wide.");
+        static_assert(is_integral_v<remove_cv_t<_ElementType>>, "Packed elements must be bool or integers.");
+
+        using offset_policy = packed_accessor;
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<_ElementType>;
+        using pointer = indexed_pointer<conditional_t<is_const_v<_ElementType>, const uint8_t, uint8_t>>;
+        using reference = conditional_t<is_const_v<_ElementType>, value_type, _Proxy_reference<packed_accessor>>;
+
+        static constexpr size_t elements_per_byte = 8 / _Bits;
+
+        // Bytes needed to hold _Count elements.
+        _NODISCARD static constexpr size_t storage_size(const size_t _Count) noexcept {
+            return (_Count + elements_per_byte - 1) / elements_per_byte;
+        }
+
+        constexpr packed_accessor() noexcept = default;
+
+        template <class _OtherElementType,
+            enable_if_t<is_convertible_v<_OtherElementType (*)[], _ElementType (*)[]>, int> = 0>
+        constexpr packed_accessor(packed_accessor<_OtherElementType, _Bits>) noexcept {}
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const noexcept {
+            return {_Ptr.data, _Ptr.index + _Idx};
+        }
+
+        _NODISCARD constexpr reference access(pointer _Ptr, size_t _Idx) const noexcept {
+            if constexpr (is_const_v<_ElementType>) {
+                return _Load(_Ptr, _Idx);
+            } else {
+                return reference{*this, _Ptr, _Idx};
+            }
+        }
+
+    private:
+        friend _Proxy_reference<packed_accessor>;
+
+        static constexpr unsigned int _Mask = (1u << _Bits) - 1;
+
+        _NODISCARD static constexpr value_type _Load(pointer _Ptr, size_t _Idx) noexcept {
+            _Idx += _Ptr.index;
+            const auto _Shift = static_cast<unsigned int>(_Idx % elements_per_byte * _Bits);
+            return static_cast<value_type>((_Ptr.data[_Idx / elements_per_byte] >> _Shift) & _Mask);
+        }
+
+        static constexpr void _Store(pointer _Ptr, size_t _Idx, const value_type& _Val) noexcept {
+            _Idx += _Ptr.index;
+            const auto _Shift = static_cast<unsigned int>(_Idx % elements_per_byte * _Bits);
+            auto& _Byte = _Ptr.data[_Idx / elements_per_byte];
+            _Byte = static_cast<uint8_t>(
+                (_Byte & ~(_Mask << _Shift)) | ((static_cast<unsigned int>(_Val) & _Mask) << _Shift));
+        }
+    };
+
+    template <class _ElementType>
+    using bit_accessor = packed_accessor<_ElementType, 1>;
+
+    template <class _ElementType>
+    using nibble_accessor = packed_accessor<_ElementType, 4>;
+
+    inline void _Prefetch(const void* const _Addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(_Addr);
+#elif defined(_M_IX86) || defined(_M_X64)
+        _mm_prefetch(static_cast<const char*>(_Addr), _MM_HINT_T0);
+#elif defined(_M_ARM64)
+        __prefetch(_Addr);
+#else
+        (void) _Addr;
+#endif
+    }
+
+    // Like default_accessor, but each access also prefetches the element distance() offsets ahead. Set the
+    // distance to k * stride(d) to run k elements ahead along dimension d, which helps the walks that hardware
+    // prefetchers give up on: layout_stride, and columns of layout_right. Prefetching past the end is harmless.
+    template <class _ElementType>
+    class prefetch_accessor {
+    public:
+        using offset_policy = prefetch_accessor;
+        using element_type = _ElementType;
+        using reference = _ElementType&;
+        using pointer = _ElementType*;
+
+        constexpr prefetch_accessor() noexcept = default;
+
+        explicit constexpr prefetch_accessor(const ptrdiff_t _Distance_) noexcept : _Distance(_Distance_) {}
+
+        template <class _OtherElementType,
+            enable_if_t<is_convertible_v<_OtherElementType (*)[], _ElementType (*)[]>, int> = 0>
+        constexpr prefetch_accessor(const prefetch_accessor<_OtherElementType>& _Other) noexcept
+            : _Distance(_Other.distance()) {}
+
+        _NODISCARD constexpr ptrdiff_t distance() const noexcept {
+            return _Distance;
+        }
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const noexcept {
+            return _Ptr + _Idx;
+        }
+
+        _NODISCARD constexpr reference access(pointer _Ptr, size_t _Idx) const noexcept {
+            if (!_STD is_constant_evaluated() && _Distance != 0) {
+                // Integer arithmetic: the target may lie outside the array.
+                const auto _Target = reinterpret_cast<uintptr_t>(_Ptr + _Idx)
+                                   + static_cast<uintptr_t>(_Distance * static_cast<ptrdiff_t>(sizeof(_ElementType)));
+                _Prefetch(reinterpret_cast<const void*>(_Target));
+            }
+            return _Ptr[_Idx];
+        }
+
+    private:
+        ptrdiff_t _Distance = 0;
+    };
+
+    // Views _Span through a prefetch_accessor that runs _Ahead elements ahead along dimension _Dim.
+    template <class _ElementType, class _Extents, class _LayoutPolicy>
+    _NODISCARD mdspan<_ElementType, _Extents, _LayoutPolicy, prefetch_accessor<_ElementType>> prefetch_along(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy>& _Span, const size_t _Dim, const ptrdiff_t _Ahead) {
+        static_assert(_LayoutPolicy::template mapping<_Extents>::is_always_strided(),
+            "prefetch_along requires a strided layout.");
+        _STL_VERIFY(_Dim < _Extents::rank(), "prefetch_along dimension out of range.");
+        return {_Span.data(), _Span.mapping(),
+            prefetch_accessor<_ElementType>{_Ahead * static_cast<ptrdiff_t>(_Span.stride(_Dim))}};
+    }
+
+    // Which accesses an access_profile records: bursts of burst consecutive accesses, one burst starting every
+    // period accesses, up to max_samples in total. Strides and reuse distances are measured within bursts.
+    struct access_sampling {
+        size_t burst = 4096;
+        size_t period = 4096;
+        size_t max_samples = size_t{1} << 20;
+        size_t line_size = 64;
+    };
+
+    struct access_report {
+        size_t accesses = 0;
+        size_t samples = 0;
+        // Element stride between consecutive sampled accesses -> count.
+        map<ptrdiff_t, size_t> strides;
+        // Reuse distance in distinct cache lines: bucket 0 counts distance 0, bucket k counts [2^(k-1), 2^k).
+        vector<size_t> reuse_distances;
+        // Sampled accesses to a line not seen earlier in their burst.
+        size_t cold_accesses = 0;
+        // Bytes of distinct elements touched over bytes of distinct cache lines touched.
+        double line_utilization = 0;
+
+        // The most frequent stride, or 0 with fewer than two samples.
+        _NODISCARD ptrdiff_t dominant_stride() const noexcept {
+            ptrdiff_t _Result = 0;
+            size_t _Best = 0;
+            for (const auto& [_Stride, _Count] : strides) {
+                if (_Count > _Best) {
+                    _Result = _Stride;
+                    _Best = _Count;
+                }
+            }
+            return _Result;
+        }
+    };
+
+    // Collects the offsets that a profiling_accessor's access() produces. Recording is thread-safe, though strides
+    // and reuse distances are only meaningful for a single-threaded walk.
+    class access_profile {
+    public:
+        explicit access_profile(const access_sampling& _Sampling_ = {}) : _Sampling(_Sampling_) {
+            _STL_VERIFY(_Sampling.burst > 0 && _Sampling.burst <= _Sampling.period && _Sampling.line_size > 0,
+                "Sampling needs 0 < burst <= period and a nonzero line size.");
+        }
+
+        access_profile(const access_profile&) = delete;
+        access_profile& operator=(const access_profile&) = delete;
+
+        // _Element_bits_ is the size of the storage one offset step covers, which is less than a byte when packed.
+        void record(const size_t _Offset, const size_t _Element_bits_) {
+            const size_t _Sequence = _Accesses.fetch_add(1, memory_order_relaxed);
+            if (_Sequence % _Sampling.period >= _Sampling.burst) {
+                return;
+            }
+
+            lock_guard _Lock(_Mutex);
+            if (_Samples.size() < _Sampling.max_samples) {
+                _Samples.push_back({_Sequence, _Offset});
+                _Element_bits = _Element_bits_;
+            }
+        }
+
+        _NODISCARD size_t access_count() const noexcept {
+            return _Accesses.load(memory_order_relaxed);
+        }
+
+        void reset() {
+            lock_guard _Lock(_Mutex);
+            _Accesses.store(0, memory_order_relaxed);
+            _Samples.clear();
+        }
+
+        _NODISCARD access_report report() const {
+            lock_guard _Lock(_Mutex);
+            access_report _Result;
+            _Result.accesses = access_count();
+            _Result.samples = _Samples.size();
+            if (_Samples.empty()) {
+                return _Result;
+            }
+
+            const size_t _Line_bits = _Sampling.line_size * CHAR_BIT;
+            unordered_map<size_t, size_t> _All_elements;
+            unordered_map<size_t, size_t> _All_lines;
+            for (const auto& _Sample : _Samples) {
+                ++_All_elements[_Sample._Offset];
+                ++_All_lines[_Sample._Offset * _Element_bits / _Line_bits];
+            }
+            _Result.line_utilization = static_cast<double>(_All_elements.size() * _Element_bits)
+                                     / static_cast<double>(_All_lines.size() * _Line_bits);
+
+            size_t _Begin = 0;
+            while (_Begin < _Samples.size()) {
+                size_t _End = _Begin + 1;
+                const size_t _Burst = _Samples[_Begin]._Sequence / _Sampling.period;
+                while (_End < _Samples.size() && _Samples[_End]._Sequence / _Sampling.period == _Burst
+                       && _Samples[_End]._Sequence == _Samples[_End - 1]._Sequence + 1) {
+                    ++_End;
+                }
+                _Analyze_burst(_Result, _Begin, _End);
+                _Begin = _End;
+            }
+
+            return _Result;
+        }
+
+    private:
+        struct _Sample_t {
+            size_t _Sequence;
+            size_t _Offset;
+        };
+
+        // Reuse distances by the usual stack-distance count: a Fenwick tree marks, for each line, the time of its
+        // latest access, so the lines touched since t are the marks after t.
+        void _Analyze_burst(access_report& _Result, const size_t _Begin, const size_t _End) const {
+            const size_t _Count = _End - _Begin;
+            vector<size_t> _Tree(_Count + 1);
+            const auto _Add = [&](size_t _Pos, const size_t _Delta) {
+                for (++_Pos; _Pos <= _Count; _Pos += _Pos & (0 - _Pos)) {
+                    _Tree[_Pos] += _Delta;
+                }
+            };
+            const auto _Prefix = [&](size_t _Pos) {
+                size_t _Sum = 0;
+                for (; _Pos > 0; _Pos -= _Pos & (0 - _Pos)) {
+                    _Sum += _Tree[_Pos];
+                }
+                return _Sum;
+            };
+
+            unordered_map<size_t, size_t> _Last_use;
+            for (size_t _Time = 0; _Time < _Count; ++_Time) {
+                const auto& _Sample = _Samples[_Begin + _Time];
+                if (_Time > 0) {
+                    const auto _Previous = static_cast<ptrdiff_t>(_Samples[_Begin + _Time - 1]._Offset);
+                    ++_Result.strides[static_cast<ptrdiff_t>(_Sample._Offset) - _Previous];
+                }
+
+                const size_t _Line = _Sample._Offset * _Element_bits / (_Sampling.line_size * CHAR_BIT);
+                const auto _Found = _Last_use.find(_Line);
+                if (_Found == _Last_use.end()) {
+                    ++_Result.cold_accesses;
+                    _Last_use.emplace(_Line, _Time);
+                } else {
+                    const size_t _Distance = _Prefix(_Time) - _Prefix(_Found->second + 1);
+                    const size_t _Bucket = _Distance == 0 ? 0 : static_cast<size_t>(_STD bit_width(_Distance));
+                    if (_Result.reuse_distances.size() <= _Bucket) {
+                        _Result.reuse_distances.resize(_Bucket + 1);
+                    }
+                    ++_Result.reuse_distances[_Bucket];
+                    _Add(_Found->second, static_cast<size_t>(-1));
+                    _Found->second = _Time;
+                }
+                _Add(_Time, 1);
+            }
+        }
+
+        access_sampling _Sampling;
+        atomic<size_t> _Accesses{0};
+        mutable mutex _Mutex;
+        vector<_Sample_t> _Samples;
+        size_t _Element_bits = CHAR_BIT;
+    };
+
+    // Bits of storage per offset step of _Accessor: the size of what its pointer points at, or the packed width.
+    template <class _Pointer, class _ElementType>
+    inline constexpr size_t _Pointer_storage_bits = sizeof(_ElementType) * CHAR_BIT;
+
+    template <class _Storage, class _ElementType>
+    inline constexpr size_t _Pointer_storage_bits<_Storage*, _ElementType> = sizeof(_Storage) * CHAR_BIT;
+
+    template <class _Storage, class _ElementType>
+    inline constexpr size_t _Pointer_storage_bits<indexed_pointer<_Storage>, _ElementType> =
+        sizeof(_Storage) * CHAR_BIT;
+
+    template <class _Accessor>
+    inline constexpr size_t _Storage_bits_v =
+        _Pointer_storage_bits<typename _Accessor::pointer, typename _Accessor::element_type>;
+
+    template <class _ElementType, size_t _Bits>
+    inline constexpr size_t _Storage_bits_v<packed_accessor<_ElementType, _Bits>> = _Bits;
+
+    template <class _Accessor>
+    inline constexpr size_t _Storage_bits_v<checked_accessor<_Accessor>> = _Storage_bits_v<_Accessor>;
+
+    // Wraps _Accessor and records the offset of every access() in an access_profile.
+    template <class _Accessor>
+    class profiling_accessor {
+    public:
+        using offset_policy = profiling_accessor<typename _Accessor::offset_policy>;
+        using element_type = typename _Accessor::element_type;
+        using reference = typename _Accessor::reference;
+        using pointer = typename _Accessor::pointer;
+
+        constexpr profiling_accessor() noexcept(is_nothrow_default_constructible_v<_Accessor>) = default;
+
+        constexpr profiling_accessor(const _Accessor& _Acc_, access_profile* const _Profile_) noexcept(
+            is_nothrow_copy_constructible_v<_Accessor>)
+            : _Acc(_Acc_), _Profile(_Profile_) {}
+
+        template <class _OtherAccessor, enable_if_t<is_constructible_v<_Accessor, const _OtherAccessor&>, int> = 0>
+        constexpr profiling_accessor(const profiling_accessor<_OtherAccessor>& _Other)
+            : _Acc(_Other.nested_accessor()), _Profile(_Other.profile()) {}
+
+        _NODISCARD constexpr const _Accessor& nested_accessor() const noexcept {
+            return _Acc;
+        }
+
+        _NODISCARD constexpr access_profile* profile() const noexcept {
+            return _Profile;
+        }
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const {
+            return _Acc.offset(_Ptr, _Idx);
+        }
+
+        _NODISCARD reference access(pointer _Ptr, size_t _Idx) const {
+            if (_Profile) {
+                _Profile->record(_Idx, _Storage_bits_v<_Accessor>);
+            }
+            return _Acc.access(_Ptr, _Idx);
+        }
+
+    private:
+        _Accessor _Acc{};
+        access_profile* _Profile = nullptr;
+    };
+
+    // Views _Span through a profiling_accessor that records into _Profile.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD mdspan<_ElementType, _Extents, _LayoutPolicy, profiling_accessor<_AccessorPolicy>> profile_accesses(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _Span, access_profile& _Profile) {
+        return {_Span.data(), _Span.mapping(), profiling_accessor<_AccessorPolicy>{_Span.accessor(), &_Profile}};
+    }
+
+    template <class _Ty>
+    struct _Member_pointer_traits;
+
+    template <class _Class, class _Ty>
+    struct _Member_pointer_traits<_Ty _Class::*> {
+        using _Class_type = _Class;
+        using _Member_type = _Ty;
+    };
+
+    template <auto _Member>
+    using _Soa_field_t = typename _Member_pointer_traits<decltype(_Member)>::_Member_type;
+
+    template <auto _Left, auto _Right>
+    _NODISCARD constexpr bool _Same_member() noexcept {
+        if constexpr (is_same_v<decltype(_Left), decltype(_Right)>) {
+            return _Left == _Right;
+        } else {
+            return false;
+        }
+    }
+
+    // Structure of arrays: each listed member of _ElementType lives in its own plane, and the data handle is a tuple
+    // of plane pointers. Every plane uses the same mapping, so a plane holds required_span_size() elements. Reading
+    // an element gathers a _ElementType from the planes, writing one scatters it; soa_field gives the mdspan of a
+    // single plane for kernels that only touch one member.
+    template <class _ElementType, auto... _Members>
+    class soa_accessor {
+    public:
+        static_assert(sizeof...(_Members) > 0, "An SoA accessor needs at least one member.");
+        static_assert(
+            (is_same_v<typename _Member_pointer_traits<decltype(_Members)>::_Class_type, remove_cv_t<_ElementType>>
+                && ...),
+            "SoA members must be data members of the element type.");
+
+        using offset_policy = soa_accessor;
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<_ElementType>;
+        using pointer = conditional_t<is_const_v<_ElementType>, tuple<const _Soa_field_t<_Members>*...>,
+            tuple<_Soa_field_t<_Members>*...>>;
+        using reference = conditional_t<is_const_v<_ElementType>, value_type, _Proxy_reference<soa_accessor>>;
+
+        constexpr soa_accessor() noexcept = default;
+
+        template <class _OtherElementType,
+            enable_if_t<is_convertible_v<_OtherElementType (*)[], _ElementType (*)[]>, int> = 0>
+        constexpr soa_accessor(soa_accessor<_OtherElementType, _Members...>) noexcept {}
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(const pointer& _Ptr, size_t _Idx) const noexcept {
+            return _STD apply([_Idx](auto... _Planes) { return pointer{(_Planes + _Idx)...}; }, _Ptr);
+        }
+
+        _NODISCARD constexpr reference access(const pointer& _Ptr, size_t _Idx) const noexcept {
+            if constexpr (is_const_v<_ElementType>) {
+                return _Load(_Ptr, _Idx);
+            } else {
+                return reference{*this, _Ptr, _Idx};
+            }
+        }
+
+        // Position of _Member among _Members.
+        template <auto _Member>
+        _NODISCARD static constexpr size_t field_index() noexcept {
+            constexpr bool _Matches[] = {_Same_member<_Member, _Members>()...};
+            for (size_t _Idx = 0; _Idx < sizeof...(_Members); ++_Idx) {
+                if (_Matches[_Idx]) {
+                    return _Idx;
+                }
+            }
+            return sizeof...(_Members);
+        }
+
+    private:
+        friend _Proxy_reference<soa_accessor>;
+
+        _NODISCARD static constexpr value_type _Load(const pointer& _Ptr, size_t _Idx) noexcept {
+            return _Load_impl(_Ptr, _Idx, make_index_sequence<sizeof...(_Members)>{});
+        }
+
+        template <size_t... _Fields>
+        _NODISCARD static constexpr value_type _Load_impl(
+            const pointer& _Ptr, size_t _Idx, index_sequence<_Fields...>) noexcept {
+            value_type _Result{};
+            ((_Result.*_Members = _STD get<_Fields>(_Ptr)[_Idx]), ...);
+            return _Result;
+        }
+
+        static constexpr void _Store(const pointer& _Ptr, size_t _Idx, const value_type& _Val) noexcept {
+            _Store_impl(_Ptr, _Idx, _Val, make_index_sequence<sizeof...(_Members)>{});
+        }
+
+        template <size_t... _Fields>
+        static constexpr void _Store_impl(
+            const pointer& _Ptr, size_t _Idx, const value_type& _Val, index_sequence<_Fields...>) noexcept {
+            ((_STD get<_Fields>(_Ptr)[_Idx] = _Val.*_Members), ...);
+        }
+    };
+
+    // The plane of _Member as an ordinary mdspan with the same extents and mapping.
+    template <auto _Member, class _ElementType, class _Extents, class _LayoutPolicy, auto... _Members>
+    _NODISCARD constexpr auto soa_field(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, soa_accessor<_ElementType, _Members...>>& _Span) {
+        using _Accessor = soa_accessor<_ElementType, _Members...>;
+        constexpr size_t _Index = _Accessor::template field_index<_Member>();
+        static_assert(_Index < sizeof...(_Members), "The member is not one of the accessor's planes.");
+
+        using _Field_t = conditional_t<is_const_v<_ElementType>, const _Soa_field_t<_Member>, _Soa_field_t<_Member>>;
+        return mdspan<_Field_t, _Extents, _LayoutPolicy>{_STD get<_Index>(_Span.data()), _Span.mapping()};
+    }
+} // namespace std
@@ -0,0 +1,183 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdarray.h"
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace std {
+    // A bump allocator for short-lived scratch memory. Allocation advances an offset within the current chunk;
+    // individual deallocation is a no-op, and memory comes back all at once through release() or reset(). Chunks
+    // are kept for reuse, so a warmed-up arena stops calling the system allocator. Not thread-safe; see
+    // thread_arena().
+    class arena {
+    public:
+        static constexpr size_t default_alignment = 64;
+
+        struct marker {
+            size_t _Chunk = 0;
+            size_t _Offset = 0;
+        };
+
+        explicit arena(const size_t _Chunk_size_ = size_t{1} << 20) noexcept : _Chunk_size(_Chunk_size_) {}
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena() {
+            for (const auto& _Chunk : _Chunks) {
+                ::operator delete(_Chunk._Data, align_val_t{default_alignment});
+            }
+        }
+
+        // _Alignment must be a power of two; alignments up to default_alignment cost nothing extra.
+        _NODISCARD void* allocate(const size_t _Bytes, const size_t _Alignment = default_alignment) {
+            _STL_VERIFY(_Alignment != 0 && (_Alignment & (_Alignment - 1)) == 0, "Alignment must be a power of two.");
+            for (;;) {
+                if (_Current < _Chunks.size()) {
+                    const auto& _Chunk = _Chunks[_Current];
+                    const size_t _Begin = _Align_up(reinterpret_cast<uintptr_t>(_Chunk._Data) + _Offset, _Alignment)
+                                        - reinterpret_cast<uintptr_t>(_Chunk._Data);
+                    if (_Begin <= _Chunk._Size && _Bytes <= _Chunk._Size - _Begin) {
+                        _Offset = _Begin + _Bytes;
+                        return _Chunk._Data + _Begin;
+                    }
+
+                    if (_Current + 1 < _Chunks.size()) {
+                        ++_Current;
+                        _Offset = 0;
+                        continue;
+                    }
+                }
+
+                // Grow. A request larger than the chunk size gets a chunk of its own size.
+                const size_t _Padding = _Alignment > default_alignment ? _Alignment : 0;
+                _STL_VERIFY(_Bytes <= SIZE_MAX - _Padding, "Arena allocation size overflow.");
+                const size_t _Size = (_STD max)(_Chunk_size, _Bytes + _Padding);
+                auto* const _Data = static_cast<char*>(::operator new(_Size, align_val_t{default_alignment}));
+                _Chunks.insert(_Chunks.begin() + static_cast<ptrdiff_t>(_Chunks.empty() ? 0 : _Current + 1),
+                    _Chunk_t{_Data, _Size});
+                _Current = _Chunks.size() == 1 ? 0 : _Current + 1;
+                _Offset = 0;
+            }
+        }
+
+        void deallocate(void*, size_t) noexcept {}
+
+        _NODISCARD marker mark() const noexcept {
+            return {_Current, _Offset};
+        }
+
+        // Frees everything allocated since _Mark was taken.
+        void release(const marker& _Mark) noexcept {
+            _Current = _Mark._Chunk;
+            _Offset = _Mark._Offset;
+        }
+
+        void reset() noexcept {
+            release({});
+        }
+
+        _NODISCARD size_t bytes_used() const noexcept {
+            size_t _Result = _Offset;
+            for (size_t _Idx = 0; _Idx < _Current && _Idx < _Chunks.size(); ++_Idx) {
+                _Result += _Chunks[_Idx]._Size;
+            }
+            return _Result;
+        }
+
+        _NODISCARD size_t capacity() const noexcept {
+            size_t _Result = 0;
+            for (const auto& _Chunk : _Chunks) {
+                _Result += _Chunk._Size;
+            }
+            return _Result;
+        }
+
+    private:
+        struct _Chunk_t {
+            char* _Data;
+            size_t _Size;
+        };
+
+        _NODISCARD static size_t _Align_up(const uintptr_t _Value, const size_t _Alignment) noexcept {
+            return static_cast<size_t>((_Value + _Alignment - 1) & ~(uintptr_t{_Alignment} - 1));
+        }
+
+        size_t _Chunk_size;
+        vector<_Chunk_t> _Chunks;
+        size_t _Current = 0;
+        size_t _Offset = 0;
+    };
+
+    // This thread's arena, the default for arena_allocator and arena_scope.
+    _NODISCARD inline arena& thread_arena() {
+        thread_local arena _Arena;
+        return _Arena;
+    }
+
+    // Releases everything allocated from the arena during the scope's lifetime. Containers using the arena must
+    // not outlive the scope.
+    class arena_scope {
+    public:
+        explicit arena_scope(arena& _Arena_ = thread_arena()) noexcept : _Arena(_Arena_), _Mark(_Arena_.mark()) {}
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+
+        ~arena_scope() {
+            _Arena.release(_Mark);
+        }
+
+    private:
+        arena& _Arena;
+        arena::marker _Mark;
+    };
+
+    // A standard allocator drawing from an arena, aligned to at least arena::default_alignment. Default-constructed
+    // allocators use thread_arena(), so containers sized by a constructor argument, like mdarray's, need no setup.
+    template <class _Ty>
+    class arena_allocator {
+    public:
+        using value_type = _Ty;
+
+        arena_allocator() : _Arena(&thread_arena()) {}
+
+        explicit arena_allocator(arena& _Arena_) noexcept : _Arena(&_Arena_) {}
+
+        template <class _Other>
+        arena_allocator(const arena_allocator<_Other>& _Other_alloc) noexcept : _Arena(&_Other_alloc.get_arena()) {}
+
+        _NODISCARD _Ty* allocate(const size_t _Count) {
+            if (_Count > SIZE_MAX / sizeof(_Ty)) {
+                throw bad_array_new_length{};
+            }
+            return static_cast<_Ty*>(
+                _Arena->allocate(_Count * sizeof(_Ty), (_STD max)(alignof(_Ty), arena::default_alignment)));
+        }
+
+        void deallocate(_Ty* const _Ptr, const size_t _Count) noexcept {
+            _Arena->deallocate(_Ptr, _Count * sizeof(_Ty));
+        }
+
+        _NODISCARD arena& get_arena() const noexcept {
+            return *_Arena;
+        }
+
+        template <class _Other>
+        _NODISCARD bool operator==(const arena_allocator<_Other>& _Right) const noexcept {
+            return _Arena == &_Right.get_arena();
+        }
+
+    private:
+        arena* _Arena;
+    };
+
+    // A scratch mdarray whose elements live in the current thread's arena.
+    template <class _ElementType, class _Extents, class _LayoutPolicy = layout_right>
+    using arena_mdarray =
+        mdarray<_ElementType, _Extents, _LayoutPolicy, vector<_ElementType, arena_allocator<_ElementType>>>;
+} // namespace std
@@ -0,0 +1,69 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+// Row-order reductions over layout_right, layout_left and a padded layout_stride for a sweep of square sizes,
+// with hardware counters. layout_right walks memory in order, layout_left jumps a column per access, and the
+// padded layout_stride walks in order but touches extra lines at row ends.
+//
+// Usage: layout_benchmark [output.json | -] [max_size] [repetitions]
+
+#include "mdspan.h"
+#include "perf_harness.h"
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+
+namespace {
+    volatile double sink;
+
+    template <class Span>
+    void row_order_sum(const Span& m) {
+        double sum = 0;
+        for (size_t i = 0; i < m.extent(0); ++i) {
+            for (size_t j = 0; j < m.extent(1); ++j) {
+                sum += m(i, j);
+            }
+        }
+        sink = sum;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 && string(argv[1]) != "-" ? argv[1] : nullptr;
+    const size_t max_size = argc > 2 ? strtoull(argv[2], nullptr, 10) : 4096;
+    const size_t repetitions = argc > 3 ? strtoull(argv[3], nullptr, 10) : 5;
+    using E = dextents<size_t, 2>;
+
+    mdspan_bench::harness bench(repetitions);
+    if (!bench.counters_available()) {
+        fprintf(stderr, "Hardware counters are unavailable; reporting wall-clock time only.\n");
+    }
+
+    for (size_t n = 64; n <= max_size; n *= 2) {
+        const size_t pitch = n + 8;
+        vector<double> data(n * pitch);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<double>(i % 11);
+        }
+
+        const string size = to_string(n);
+        bench.run("row_order_sum", {{"layout", "layout_right"}, {"size", size}}, n * n,
+            [&] { row_order_sum(mdspan<double, E>(data.data(), n, n)); });
+        bench.run("row_order_sum", {{"layout", "layout_left"}, {"size", size}}, n * n,
+            [&] { row_order_sum(mdspan<double, E, layout_left>(data.data(), n, n)); });
+        const layout_stride::mapping<E> padded{E{n, n}, array<size_t, 2>{pitch, 1}};
+        bench.run("row_order_sum", {{"layout", "layout_stride"}, {"size", size}}, n * n,
+            [&] { row_order_sum(mdspan<double, E, layout_stride>(data.data(), padded)); });
+    }
+
+    FILE* out = path ? fopen(path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return EXIT_FAILURE;
+    }
+    bench.write_json(out);
+    if (path) {
+        fclose(out);
+    }
+}
@@ -0,0 +1,199 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+// Hardware counters around benchmark kernels, and a JSON report of the results. The counters come from
+// perf_event_open on Linux; elsewhere, or where the kernel refuses (perf_event_paranoid, containers, missing PMU
+// events), they are reported as null and only wall-clock time is measured.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mdspan_bench {
+    inline constexpr size_t counter_count = 5;
+
+    inline constexpr std::array<const char*, counter_count> counter_names = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses"};
+
+    using counter_values = std::array<std::optional<double>, counter_count>;
+
+    class perf_counters {
+    public:
+        perf_counters() {
+#ifdef __linux__
+            constexpr auto cache_miss = [](uint64_t cache) {
+                return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            };
+            const std::array<std::pair<uint32_t, uint64_t>, counter_count> events = {{
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+                {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+                {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+            }};
+
+            // Separate events rather than one group, so that one unsupported event doesn't lose the rest.
+            for (size_t i = 0; i < counter_count; ++i) {
+                perf_event_attr attr{};
+                attr.size           = sizeof(attr);
+                attr.type           = events[i].first;
+                attr.config         = events[i].second;
+                attr.disabled       = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv     = 1;
+                attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            }
+#endif
+        }
+
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        ~perf_counters() {
+#ifdef __linux__
+            for (const int fd : fds) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+#endif
+        }
+
+        bool available() const noexcept {
+            return std::any_of(fds.begin(), fds.end(), [](int fd) { return fd >= 0; });
+        }
+
+        void start() noexcept {
+#ifdef __linux__
+            for (const int fd : fds) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        // Stops counting and returns the counts since start(), scaled up if the kernel multiplexed the event.
+        counter_values stop() noexcept {
+            counter_values result;
+#ifdef __linux__
+            for (const int fd : fds) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+            for (size_t i = 0; i < counter_count; ++i) {
+                uint64_t values[3]{}; // value, time enabled, time running
+                if (fds[i] >= 0 && read(fds[i], values, sizeof(values)) == sizeof(values) && values[2] != 0) {
+                    result[i] = static_cast<double>(values[0]) * static_cast<double>(values[1])
+                              / static_cast<double>(values[2]);
+                }
+            }
+#endif
+            return result;
+        }
+
+    private:
+        std::array<int, counter_count> fds{-1, -1, -1, -1, -1};
+    };
+
+    struct result {
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> parameters;
+        size_t elements = 0;
+        double nanoseconds = 0;
+        counter_values counters;
+    };
+
+    // Runs each benchmark several times and keeps the fastest run, with the counters of that run.
+    class harness {
+    public:
+        explicit harness(size_t repetitions_ = 5) : repetitions(repetitions_) {}
+
+        // Returns a copy: the recorded results grow with every run.
+        template <class Fn>
+        result run(std::string name, std::vector<std::pair<std::string, std::string>> parameters,
+            size_t elements, Fn func) {
+            result best;
+            best.name       = std::move(name);
+            best.parameters = std::move(parameters);
+            best.elements   = elements;
+            for (size_t rep = 0; rep < repetitions; ++rep) {
+                counters.start();
+                const auto start = std::chrono::steady_clock::now();
+                func();
+                const auto stop = std::chrono::steady_clock::now();
+                const auto counts = counters.stop();
+
+                const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+                if (rep == 0 || ns < best.nanoseconds) {
+                    best.nanoseconds = ns;
+                    best.counters    = counts;
+                }
+            }
+
+            results.push_back(best);
+            return best;
+        }
+
+        bool counters_available() const noexcept {
+            return counters.available();
+        }
+
+        // Writes {"counters_available": ..., "benchmarks": [...]}; counts are per element.
+        void write_json(FILE* out) const {
+            std::fprintf(out, "{\n  \"counters_available\": %s,\n  \"benchmarks\": [", counters.available() ? "true" : "false");
+            for (size_t i = 0; i < results.size(); ++i) {
+                const auto& r = results[i];
+                const double elements = static_cast<double>(r.elements ? r.elements : 1);
+                std::fprintf(out, "%s\n    {\"name\": \"%s\"", i == 0 ? "" : ",", escape(r.name).c_str());
+                for (const auto& [key, value] : r.parameters) {
+                    std::fprintf(out, ", \"%s\": \"%s\"", escape(key).c_str(), escape(value).c_str());
+                }
+                std::fprintf(out, ", \"elements\": %zu, \"ns_per_element\": %.6g", r.elements, r.nanoseconds / elements);
+                for (size_t c = 0; c < counter_count; ++c) {
+                    if (r.counters[c]) {
+                        std::fprintf(out, ", \"%s_per_element\": %.6g", counter_names[c], *r.counters[c] / elements);
+                    } else {
+                        std::fprintf(out, ", \"%s_per_element\": null", counter_names[c]);
+                    }
+                }
+                std::fprintf(out, "}");
+            }
+            std::fprintf(out, "\n  ]\n}\n");
+        }
+
+    private:
+        static std::string escape(const std::string& text) {
+            std::string escaped;
+            for (const char ch : text) {
+                if (ch == '"' || ch == '\\') {
+                    escaped += '\\';
+                }
+                escaped += ch;
+            }
+            return escaped;
+        }
+
+        size_t repetitions;
+        perf_counters counters;
+        std::vector<result> results;
+    };
+} // namespace mdspan_bench
@@ -0,0 +1,88 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+// Sweeps the prefetch distance of prefetch_along for column reductions, the latency-bound case: columns of a
+// layout_right matrix, and rows of a layout_stride matrix with a large, irregular pitch.
+//
+// Usage: prefetch_benchmark [rows] [cols] [repetitions]
+
+#include "accessors.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    template <class Span>
+    double column_sums(const Span& m, vector<double>& sums) {
+        for (size_t j = 0; j < m.extent(1); ++j) {
+            double sum = 0;
+            for (size_t i = 0; i < m.extent(0); ++i) {
+                sum += m(i, j);
+            }
+            sums[j] = sum;
+        }
+
+        double total = 0;
+        for (const double sum : sums) {
+            total += sum;
+        }
+        return total;
+    }
+
+    template <class Span>
+    void sweep(const char* name, const Span& m, const size_t repetitions) {
+        constexpr ptrdiff_t distances[] = {0, 1, 2, 4, 8, 16, 32, 64};
+        vector<double> sums(m.extent(1));
+        double baseline = 0;
+        double checksum = column_sums(m, sums);
+
+        printf("%s (%zu x %zu)\n%10s %12s %10s\n", name, m.extent(0), m.extent(1), "distance", "ns/element",
+            "speedup");
+        for (const ptrdiff_t distance : distances) {
+            const auto prefetching = prefetch_along(m, 0, distance);
+            double best = 1e300;
+            for (size_t rep = 0; rep < repetitions; ++rep) {
+                const auto start = chrono::steady_clock::now();
+                const double result = column_sums(prefetching, sums);
+                const auto stop = chrono::steady_clock::now();
+                if (result != checksum) {
+                    fprintf(stderr, "checksum mismatch at distance %td\n", distance);
+                    exit(EXIT_FAILURE);
+                }
+                best = (min)(best, chrono::duration<double, nano>(stop - start).count());
+            }
+
+            const double per_element = best / static_cast<double>(m.size());
+            if (distance == 0) {
+                baseline = per_element;
+            }
+            printf("%10td %12.3f %10.2f\n", distance, per_element, baseline / per_element);
+        }
+        printf("\n");
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t rows = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4096;
+    const size_t cols = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1024;
+    const size_t repetitions = argc > 3 ? strtoull(argv[3], nullptr, 10) : 5;
+    using E = dextents<size_t, 2>;
+
+    vector<double> data(rows * cols);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<double>(i % 17);
+    }
+    sweep("layout_right, column walk", mdspan<double, E>(data.data(), rows, cols), repetitions);
+
+    // An odd pitch, several pages per row, so consecutive rows land in unrelated pages.
+    const size_t pitch = cols * 5 + 3;
+    vector<double> padded(rows * pitch);
+    for (size_t i = 0; i < padded.size(); ++i) {
+        padded[i] = static_cast<double>(i % 17);
+    }
+    const layout_stride::mapping<E> map{E{rows, cols}, array<size_t, 2>{pitch, 1}};
+    sweep("layout_stride, column walk", mdspan<double, E, layout_stride>(padded.data(), map), repetitions);
+}
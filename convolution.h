@@ -0,0 +1,488 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <vector>
+
+namespace std {
+    // 2-D correlation and convolution of multi-channel images. Images are rank 4 (batch, channel, row, column in
+    // the order given by the format tag) or rank 3 (one image, no batch dimension); kernels are rank 4 (output
+    // channel, input channel, row, column) and the output uses the input's format. Three algorithms are
+    // available: direct summation, im2col (copying each image's receptive fields into a matrix and multiplying
+    // by the kernel matrix), and Winograd F(2x2, 3x3). By default the kernel's static extents pick one: Winograd
+    // for a 3x3 kernel with stride 1, direct for 1x1, and im2col otherwise. The work_stealing_pool overloads
+    // split the work by image and output channel.
+
+    struct nchw_t {
+        explicit nchw_t() = default;
+    };
+    inline constexpr nchw_t nchw{};
+
+    struct nhwc_t {
+        explicit nhwc_t() = default;
+    };
+    inline constexpr nhwc_t nhwc{};
+
+    enum class conv2d_algorithm { automatic, direct, im2col, winograd };
+
+    struct conv2d_options {
+        size_t stride = 1;
+        // Zero padding added on every side of the image.
+        size_t padding = 0;
+        conv2d_algorithm algorithm = conv2d_algorithm::automatic;
+    };
+
+    // An image mdspan indexed as (image, channel, row, column) whatever its format and rank.
+    template <class _Span, class _Format>
+    class _Conv_image {
+    public:
+        static_assert(_Span::rank() == 3 || _Span::rank() == 4, "Convolution images must have rank 3 or 4.");
+
+        using value_type = typename _Span::value_type;
+        static constexpr size_t _First = _Span::rank() - 3;
+        static constexpr bool _Channels_first = is_same_v<_Format, nchw_t>;
+
+        explicit _Conv_image(const _Span& _View_) : _View(_View_) {}
+
+        _NODISCARD size_t _Batch() const {
+            if constexpr (_First == 1) {
+                return _View.extent(0);
+            } else {
+                return 1;
+            }
+        }
+
+        _NODISCARD size_t _Channels() const {
+            return _View.extent(_Channels_first ? _First : _First + 2);
+        }
+
+        _NODISCARD size_t _Height() const {
+            return _View.extent(_Channels_first ? _First + 1 : _First);
+        }
+
+        _NODISCARD size_t _Width() const {
+            return _View.extent(_Channels_first ? _First + 2 : _First + 1);
+        }
+
+        _NODISCARD decltype(auto) operator()(
+            const size_t _Image, const size_t _Channel, const size_t _Row, const size_t _Col) const {
+            if constexpr (_First == 1) {
+                if constexpr (_Channels_first) {
+                    return _View(_Image, _Channel, _Row, _Col);
+                } else {
+                    return _View(_Image, _Row, _Col, _Channel);
+                }
+            } else {
+                (void) _Image;
+                if constexpr (_Channels_first) {
+                    return _View(_Channel, _Row, _Col);
+                } else {
+                    return _View(_Row, _Col, _Channel);
+                }
+            }
+        }
+
+    private:
+        _Span _View;
+    };
+
+    // The problem's extents, and the kernel as a contiguous [out channel][in channel][row][column] array, flipped
+    // for convolution.
+    template <class _Ty>
+    struct _Conv_problem {
+        size_t _Batch;
+        size_t _In_channels;
+        size_t _Height;
+        size_t _Width;
+        size_t _Out_channels;
+        size_t _Kernel_h;
+        size_t _Kernel_w;
+        size_t _Out_h;
+        size_t _Out_w;
+        size_t _Stride;
+        size_t _Padding;
+        vector<_Ty> _Weights;
+
+        _NODISCARD const _Ty* _Filter(const size_t _Out_channel) const noexcept {
+            return _Weights.data() + _Out_channel * _In_channels * _Kernel_h * _Kernel_w;
+        }
+
+        // Input row or column for output position _Out and kernel tap _Tap, or -1 if it falls in the padding.
+        _NODISCARD static ptrdiff_t _Source(
+            const size_t _Out, const size_t _Tap, const size_t _Stride_, const size_t _Padding_, const size_t _Limit) {
+            const auto _Pos = static_cast<ptrdiff_t>(_Out * _Stride_ + _Tap) - static_cast<ptrdiff_t>(_Padding_);
+            return _Pos >= 0 && _Pos < static_cast<ptrdiff_t>(_Limit) ? _Pos : -1;
+        }
+    };
+
+    template <class _In, class _Out>
+    void _Conv_direct(const _In& _Input, const _Out& _Output, const _Conv_problem<typename _Out::value_type>& _Prob,
+        const size_t _Image, const size_t _First_k, const size_t _Last_k) {
+        using _Ty = typename _Out::value_type;
+        for (size_t _K = _First_k; _K < _Last_k; ++_K) {
+            const _Ty* const _Filter = _Prob._Filter(_K);
+            for (size_t _Row = 0; _Row < _Prob._Out_h; ++_Row) {
+                for (size_t _Col = 0; _Col < _Prob._Out_w; ++_Col) {
+                    _Ty _Sum{};
+                    for (size_t _Channel = 0; _Channel < _Prob._In_channels; ++_Channel) {
+                        for (size_t _Kr = 0; _Kr < _Prob._Kernel_h; ++_Kr) {
+                            const ptrdiff_t _Src_row =
+                                _Prob._Source(_Row, _Kr, _Prob._Stride, _Prob._Padding, _Prob._Height);
+                            if (_Src_row < 0) {
+                                continue;
+                            }
+                            for (size_t _Kc = 0; _Kc < _Prob._Kernel_w; ++_Kc) {
+                                const ptrdiff_t _Src_col =
+                                    _Prob._Source(_Col, _Kc, _Prob._Stride, _Prob._Padding, _Prob._Width);
+                                if (_Src_col >= 0) {
+                                    _Sum += _Filter[(_Channel * _Prob._Kernel_h + _Kr) * _Prob._Kernel_w + _Kc]
+                                          * _Input(_Image, _Channel, static_cast<size_t>(_Src_row),
+                                              static_cast<size_t>(_Src_col));
+                                }
+                            }
+                        }
+                    }
+                    _Output(_Image, _K, _Row, _Col) = _Sum;
+                }
+            }
+        }
+    }
+
+    // Fills channels [_First_c, _Last_c) of the image's column matrix: _Columns[j][pixel] is tap j of the receptive
+    // field of each output pixel.
+    template <class _In, class _Ty>
+    void _Im2col_columns(const _In& _Input, const _Conv_problem<_Ty>& _Prob, const size_t _Image, const size_t _First_c,
+        const size_t _Last_c, _Ty* const _Columns) {
+        const size_t _Pixels = _Prob._Out_h * _Prob._Out_w;
+        for (size_t _Channel = _First_c; _Channel < _Last_c; ++_Channel) {
+            for (size_t _Kr = 0; _Kr < _Prob._Kernel_h; ++_Kr) {
+                for (size_t _Kc = 0; _Kc < _Prob._Kernel_w; ++_Kc) {
+                    _Ty* const _Dest =
+                        _Columns + ((_Channel * _Prob._Kernel_h + _Kr) * _Prob._Kernel_w + _Kc) * _Pixels;
+                    for (size_t _Row = 0; _Row < _Prob._Out_h; ++_Row) {
+                        const ptrdiff_t _Src_row =
+                            _Prob._Source(_Row, _Kr, _Prob._Stride, _Prob._Padding, _Prob._Height);
+                        for (size_t _Col = 0; _Col < _Prob._Out_w; ++_Col) {
+                            const ptrdiff_t _Src_col =
+                                _Prob._Source(_Col, _Kc, _Prob._Stride, _Prob._Padding, _Prob._Width);
+                            _Dest[_Row * _Prob._Out_w + _Col] =
+                                _Src_row < 0 || _Src_col < 0
+                                    ? _Ty{}
+                                    : static_cast<_Ty>(_Input(_Image, _Channel, static_cast<size_t>(_Src_row),
+                                        static_cast<size_t>(_Src_col)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Output channels and pixels per block of the kernel-by-columns product: each tap's slice of a column tile is
+    // loaded once and used for every channel of the block while it is in cache.
+    inline constexpr size_t _Conv_block_channels = 8;
+    inline constexpr size_t _Conv_block_pixels = 256;
+
+    template <class _Out>
+    void _Conv_im2col(const _Out& _Output, const _Conv_problem<typename _Out::value_type>& _Prob,
+        const typename _Out::value_type* const _Columns, const size_t _Image, const size_t _First_k,
+        const size_t _Last_k) {
+        using _Ty = typename _Out::value_type;
+        const size_t _Pixels = _Prob._Out_h * _Prob._Out_w;
+        const size_t _Patch = _Prob._In_channels * _Prob._Kernel_h * _Prob._Kernel_w;
+
+        vector<_Ty> _Sums(_Conv_block_channels * _Conv_block_pixels);
+        for (size_t _K0 = _First_k; _K0 < _Last_k; _K0 += _Conv_block_channels) {
+            const size_t _Kn = (_STD min)(_Conv_block_channels, _Last_k - _K0);
+            for (size_t _P0 = 0; _P0 < _Pixels; _P0 += _Conv_block_pixels) {
+                const size_t _Pn = (_STD min)(_Conv_block_pixels, _Pixels - _P0);
+                _STD fill_n(_Sums.begin(), _Kn * _Pn, _Ty{});
+                for (size_t _Tap = 0; _Tap < _Patch; ++_Tap) {
+                    const _Ty* const _Src = _Columns + _Tap * _Pixels + _P0;
+                    for (size_t _K = 0; _K < _Kn; ++_K) {
+                        const _Ty _Weight = _Prob._Filter(_K0 + _K)[_Tap];
+                        _Ty* const _Dest = _Sums.data() + _K * _Pn;
+                        for (size_t _Pixel = 0; _Pixel < _Pn; ++_Pixel) {
+                            _Dest[_Pixel] += _Weight * _Src[_Pixel];
+                        }
+                    }
+                }
+                for (size_t _K = 0; _K < _Kn; ++_K) {
+                    for (size_t _Pixel = 0; _Pixel < _Pn; ++_Pixel) {
+                        _Output(_Image, _K0 + _K, (_P0 + _Pixel) / _Prob._Out_w, (_P0 + _Pixel) % _Prob._Out_w) =
+                            _Sums[_K * _Pn + _Pixel];
+                    }
+                }
+            }
+        }
+    }
+
+    // Winograd F(2x2, 3x3): each 2x2 output tile is A^T [sum over channels of (G g G^T) . (B^T d B)] A, for 3x3
+    // filters g and 4x4 input tiles d, taking 16 multiplies per channel instead of 36.
+    template <class _Ty>
+    _NODISCARD vector<_Ty> _Winograd_filters(const _Conv_problem<_Ty>& _Prob) {
+        vector<_Ty> _Result(_Prob._Out_channels * _Prob._In_channels * 16);
+        const _Ty _Half{0.5};
+        for (size_t _Filter = 0; _Filter < _Prob._Out_channels * _Prob._In_channels; ++_Filter) {
+            const _Ty* const _G = _Prob._Weights.data() + _Filter * 9;
+            _Ty _Rows[4][3];
+            for (size_t _Col = 0; _Col < 3; ++_Col) {
+                _Rows[0][_Col] = _G[_Col];
+                _Rows[1][_Col] = (_G[_Col] + _G[3 + _Col] + _G[6 + _Col]) * _Half;
+                _Rows[2][_Col] = (_G[_Col] - _G[3 + _Col] + _G[6 + _Col]) * _Half;
+                _Rows[3][_Col] = _G[6 + _Col];
+            }
+            _Ty* const _U = _Result.data() + _Filter * 16;
+            for (size_t _Row = 0; _Row < 4; ++_Row) {
+                _U[_Row * 4 + 0] = _Rows[_Row][0];
+                _U[_Row * 4 + 1] = (_Rows[_Row][0] + _Rows[_Row][1] + _Rows[_Row][2]) * _Half;
+                _U[_Row * 4 + 2] = (_Rows[_Row][0] - _Rows[_Row][1] + _Rows[_Row][2]) * _Half;
+                _U[_Row * 4 + 3] = _Rows[_Row][2];
+            }
+        }
+        return _Result;
+    }
+
+    template <class _Ty>
+    _NODISCARD size_t _Winograd_tile_count(const _Conv_problem<_Ty>& _Prob) noexcept {
+        return ((_Prob._Out_h + 1) / 2) * ((_Prob._Out_w + 1) / 2);
+    }
+
+    // Fills channels [_First_c, _Last_c) of the image's transformed input tiles B^T d B, stored as
+    // [tile][channel][16] with tiles in row-major order.
+    template <class _In, class _Ty>
+    void _Winograd_inputs(const _In& _Input, const _Conv_problem<_Ty>& _Prob, const size_t _Image,
+        const size_t _First_c, const size_t _Last_c, _Ty* const _Tiles) {
+        const size_t _Channels = _Prob._In_channels;
+        size_t _Tile = 0;
+        for (size_t _Tile_row = 0; _Tile_row < _Prob._Out_h; _Tile_row += 2) {
+            for (size_t _Tile_col = 0; _Tile_col < _Prob._Out_w; _Tile_col += 2, ++_Tile) {
+                for (size_t _Channel = _First_c; _Channel < _Last_c; ++_Channel) {
+                    _Ty _D[4][4];
+                    for (size_t _Row = 0; _Row < 4; ++_Row) {
+                        const ptrdiff_t _Src_row = _Prob._Source(_Tile_row, _Row, 1, _Prob._Padding, _Prob._Height);
+                        for (size_t _Col = 0; _Col < 4; ++_Col) {
+                            const ptrdiff_t _Src_col = _Prob._Source(_Tile_col, _Col, 1, _Prob._Padding, _Prob._Width);
+                            _D[_Row][_Col] = _Src_row < 0 || _Src_col < 0
+                                               ? _Ty{}
+                                               : static_cast<_Ty>(_Input(_Image, _Channel,
+                                                   static_cast<size_t>(_Src_row), static_cast<size_t>(_Src_col)));
+                        }
+                    }
+
+                    _Ty _Rows[4][4];
+                    for (size_t _Col = 0; _Col < 4; ++_Col) {
+                        _Rows[0][_Col] = _D[0][_Col] - _D[2][_Col];
+                        _Rows[1][_Col] = _D[1][_Col] + _D[2][_Col];
+                        _Rows[2][_Col] = _D[2][_Col] - _D[1][_Col];
+                        _Rows[3][_Col] = _D[1][_Col] - _D[3][_Col];
+                    }
+                    _Ty* const _V = _Tiles + (_Tile * _Channels + _Channel) * 16;
+                    for (size_t _Row = 0; _Row < 4; ++_Row) {
+                        _V[_Row * 4 + 0] = _Rows[_Row][0] - _Rows[_Row][2];
+                        _V[_Row * 4 + 1] = _Rows[_Row][1] + _Rows[_Row][2];
+                        _V[_Row * 4 + 2] = _Rows[_Row][2] - _Rows[_Row][1];
+                        _V[_Row * 4 + 3] = _Rows[_Row][1] - _Rows[_Row][3];
+                    }
+                }
+            }
+        }
+    }
+
+    template <class _Out>
+    void _Conv_winograd(const _Out& _Output, const _Conv_problem<typename _Out::value_type>& _Prob,
+        const vector<typename _Out::value_type>& _Filters, const typename _Out::value_type* const _Tiles,
+        const size_t _Image, const size_t _First_k, const size_t _Last_k) {
+        using _Ty = typename _Out::value_type;
+        const size_t _Channels = _Prob._In_channels;
+        size_t _Tile = 0;
+        for (size_t _Tile_row = 0; _Tile_row < _Prob._Out_h; _Tile_row += 2) {
+            for (size_t _Tile_col = 0; _Tile_col < _Prob._Out_w; _Tile_col += 2, ++_Tile) {
+                const _Ty* const _V = _Tiles + _Tile * _Channels * 16;
+                for (size_t _K = _First_k; _K < _Last_k; ++_K) {
+                    _Ty _M[16]{};
+                    const _Ty* const _U = _Filters.data() + _K * _Channels * 16;
+                    for (size_t _Channel = 0; _Channel < _Channels; ++_Channel) {
+                        for (size_t _Idx = 0; _Idx < 16; ++_Idx) {
+                            _M[_Idx] += _U[_Channel * 16 + _Idx] * _V[_Channel * 16 + _Idx];
+                        }
+                    }
+
+                    _Ty _Rows[2][4];
+                    for (size_t _Col = 0; _Col < 4; ++_Col) {
+                        _Rows[0][_Col] = _M[_Col] + _M[4 + _Col] + _M[8 + _Col];
+                        _Rows[1][_Col] = _M[4 + _Col] - _M[8 + _Col] - _M[12 + _Col];
+                    }
+                    for (size_t _Row = 0; _Row < 2 && _Tile_row + _Row < _Prob._Out_h; ++_Row) {
+                        _Output(_Image, _K, _Tile_row + _Row, _Tile_col) =
+                            _Rows[_Row][0] + _Rows[_Row][1] + _Rows[_Row][2];
+                        if (_Tile_col + 1 < _Prob._Out_w) {
+                            _Output(_Image, _K, _Tile_row + _Row, _Tile_col + 1) =
+                                _Rows[_Row][1] - _Rows[_Row][2] - _Rows[_Row][3];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template <class _InSpan, class _KernelSpan, class _OutSpan, class _Format>
+    void _Conv2d(work_stealing_pool* const _Pool, const _InSpan& _In, const _KernelSpan& _Kernel, const _OutSpan& _Out,
+        _Format, const conv2d_options& _Options, const bool _Flip) {
+        static_assert(_Is_any_of_v<_Format, nchw_t, nhwc_t>, "Image format must be nchw or nhwc.");
+        static_assert(_KernelSpan::rank() == 4, "Convolution kernels must have rank 4.");
+        static_assert(_InSpan::rank() == _OutSpan::rank(), "Convolution input and output ranks differ.");
+        using _Ty = typename _OutSpan::value_type;
+
+        const _Conv_image<_InSpan, _Format> _Input(_In);
+        const _Conv_image<_OutSpan, _Format> _Output(_Out);
+        _STL_VERIFY(_Options.stride > 0, "Convolution stride must be positive.");
+        _STL_VERIFY(_Kernel.extent(1) == _Input._Channels(), "Kernel and image channel counts differ.");
+        _STL_VERIFY(_Kernel.extent(2) > 0 && _Kernel.extent(3) > 0, "Convolution kernels must not be empty.");
+        _STL_VERIFY(_Input._Height() + 2 * _Options.padding >= _Kernel.extent(2)
+                        && _Input._Width() + 2 * _Options.padding >= _Kernel.extent(3),
+            "Convolution kernel larger than the padded image.");
+
+        _Conv_problem<_Ty> _Prob{_Input._Batch(), _Input._Channels(), _Input._Height(), _Input._Width(),
+            _Kernel.extent(0), _Kernel.extent(2), _Kernel.extent(3), 0, 0, _Options.stride, _Options.padding, {}};
+        _Prob._Out_h = (_Prob._Height + 2 * _Prob._Padding - _Prob._Kernel_h) / _Prob._Stride + 1;
+        _Prob._Out_w = (_Prob._Width + 2 * _Prob._Padding - _Prob._Kernel_w) / _Prob._Stride + 1;
+        _STL_VERIFY(_Output._Batch() == _Prob._Batch && _Output._Channels() == _Prob._Out_channels
+                        && _Output._Height() == _Prob._Out_h && _Output._Width() == _Prob._Out_w,
+            "Convolution output extents mismatch.");
+        if (_Prob._Batch == 0 || _Prob._Out_channels == 0) {
+            return;
+        }
+
+        _Prob._Weights.resize(_Prob._Out_channels * _Prob._In_channels * _Prob._Kernel_h * _Prob._Kernel_w);
+        auto _Weight = _Prob._Weights.begin();
+        for (size_t _K = 0; _K < _Prob._Out_channels; ++_K) {
+            for (size_t _Channel = 0; _Channel < _Prob._In_channels; ++_Channel) {
+                for (size_t _Kr = 0; _Kr < _Prob._Kernel_h; ++_Kr) {
+                    for (size_t _Kc = 0; _Kc < _Prob._Kernel_w; ++_Kc) {
+                        *_Weight++ = _Flip ? _Kernel(_K, _Channel, _Prob._Kernel_h - 1 - _Kr, _Prob._Kernel_w - 1 - _Kc)
+                                           : _Kernel(_K, _Channel, _Kr, _Kc);
+                    }
+                }
+            }
+        }
+
+        auto _Algorithm = _Options.algorithm;
+        if (_Algorithm == conv2d_algorithm::automatic) {
+            if constexpr (_KernelSpan::static_extent(2) == 3 && _KernelSpan::static_extent(3) == 3) {
+                _Algorithm = _Options.stride == 1 ? conv2d_algorithm::winograd : conv2d_algorithm::im2col;
+            } else if constexpr (_KernelSpan::static_extent(2) == 1 && _KernelSpan::static_extent(3) == 1) {
+                _Algorithm = conv2d_algorithm::direct;
+            } else {
+                _Algorithm = conv2d_algorithm::im2col;
+            }
+        }
+
+        // The transformed input of one image: the im2col column matrix or the Winograd input tiles.
+        size_t _Scratch = 0;
+        vector<_Ty> _Filters;
+        if (_Algorithm == conv2d_algorithm::winograd) {
+            _STL_VERIFY(_Prob._Kernel_h == 3 && _Prob._Kernel_w == 3 && _Prob._Stride == 1,
+                "Winograd convolution requires a 3x3 kernel and stride 1.");
+            _Filters = _Winograd_filters(_Prob);
+            _Scratch = _Winograd_tile_count(_Prob) * _Prob._In_channels * 16;
+        } else if (_Algorithm == conv2d_algorithm::im2col) {
+            _Scratch = _Prob._In_channels * _Prob._Kernel_h * _Prob._Kernel_w * _Prob._Out_h * _Prob._Out_w;
+        }
+
+        const auto _Transform =
+            [&](const size_t _Image, const size_t _First_c, const size_t _Last_c, _Ty* const _Dest) {
+                if (_Algorithm == conv2d_algorithm::winograd) {
+                    _Winograd_inputs(_Input, _Prob, _Image, _First_c, _Last_c, _Dest);
+                } else if (_Algorithm == conv2d_algorithm::im2col) {
+                    _Im2col_columns(_Input, _Prob, _Image, _First_c, _Last_c, _Dest);
+                }
+            };
+
+        const auto _Run = [&](const size_t _Image, const size_t _First_k, const size_t _Last_k, const _Ty* const _Src) {
+            switch (_Algorithm) {
+            case conv2d_algorithm::winograd:
+                _Conv_winograd(_Output, _Prob, _Filters, _Src, _Image, _First_k, _Last_k);
+                break;
+            case conv2d_algorithm::im2col:
+                _Conv_im2col(_Output, _Prob, _Src, _Image, _First_k, _Last_k);
+                break;
+            default:
+                _Conv_direct(_Input, _Output, _Prob, _Image, _First_k, _Last_k);
+                break;
+            }
+        };
+
+        const auto _Whole_images = [&](const size_t _First, const size_t _Last) {
+            vector<_Ty> _Buffer(_Scratch);
+            for (size_t _Image = _First; _Image < _Last; ++_Image) {
+                _Transform(_Image, 0, _Prob._In_channels, _Buffer.data());
+                _Run(_Image, 0, _Prob._Out_channels, _Buffer.data());
+            }
+        };
+
+        if (!_Pool) {
+            _Whole_images(0, _Prob._Batch);
+            return;
+        }
+
+        const size_t _Tasks = 4 * _Pool->size();
+        if (_Prob._Batch >= _Tasks) {
+            parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Prob._Batch}, array<size_t, 1>{1},
+                [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) { _Whole_images(_Lo[0], _Hi[0]); });
+            return;
+        }
+
+        // Too few images for whole-image tasks, so aim for about four tasks per worker across channels too. Every
+        // image's input is transformed once, split across input channels, and then shared by the tasks that split
+        // its output channels.
+        vector<_Ty> _Buffers(_Prob._Batch * _Scratch);
+        if (_Scratch != 0) {
+            const size_t _In_grain = (_STD max)(size_t{1}, _Prob._In_channels * _Prob._Batch / _Tasks);
+            parallel_for_tiles(*_Pool, dextents<size_t, 2>{_Prob._Batch, _Prob._In_channels},
+                array<size_t, 2>{1, _In_grain}, [&](const array<size_t, 2>& _Lo, const array<size_t, 2>& _Hi) {
+                    for (size_t _Image = _Lo[0]; _Image < _Hi[0]; ++_Image) {
+                        _Transform(_Image, _Lo[1], _Hi[1], _Buffers.data() + _Image * _Scratch);
+                    }
+                });
+        }
+
+        const size_t _Channel_grain = (_STD max)(size_t{1}, _Prob._Out_channels * _Prob._Batch / _Tasks);
+        parallel_for_tiles(*_Pool, dextents<size_t, 2>{_Prob._Batch, _Prob._Out_channels},
+            array<size_t, 2>{1, _Channel_grain}, [&](const array<size_t, 2>& _Lo, const array<size_t, 2>& _Hi) {
+                for (size_t _Image = _Lo[0]; _Image < _Hi[0]; ++_Image) {
+                    _Run(_Image, _Lo[1], _Hi[1], _Buffers.data() + _Image * _Scratch);
+                }
+            });
+    }
+
+    // _Out(n, k, p, q) = sum over c, r, s of _In(n, c, p * stride + r - padding, q * stride + s - padding)
+    // * _Kernel(k, c, r, s), in the image layout given by _Format. This is what neural networks call convolution.
+    template <class _InSpan, class _KernelSpan, class _OutSpan, class _Format>
+    void correlate2d(const _InSpan& _In, const _KernelSpan& _Kernel, const _OutSpan& _Out, const _Format _Fmt,
+        const conv2d_options& _Options = {}) {
+        _Conv2d(nullptr, _In, _Kernel, _Out, _Fmt, _Options, false);
+    }
+
+    template <class _InSpan, class _KernelSpan, class _OutSpan, class _Format>
+    void correlate2d(work_stealing_pool& _Pool, const _InSpan& _In, const _KernelSpan& _Kernel, const _OutSpan& _Out,
+        const _Format _Fmt, const conv2d_options& _Options = {}) {
+        _Conv2d(&_Pool, _In, _Kernel, _Out, _Fmt, _Options, false);
+    }
+
+    // As correlate2d with the kernel rotated by 180 degrees: true convolution.
+    template <class _InSpan, class _KernelSpan, class _OutSpan, class _Format>
+    void convolve2d(const _InSpan& _In, const _KernelSpan& _Kernel, const _OutSpan& _Out, const _Format _Fmt,
+        const conv2d_options& _Options = {}) {
+        _Conv2d(nullptr, _In, _Kernel, _Out, _Fmt, _Options, true);
+    }
+
+    template <class _InSpan, class _KernelSpan, class _OutSpan, class _Format>
+    void convolve2d(work_stealing_pool& _Pool, const _InSpan& _In, const _KernelSpan& _Kernel, const _OutSpan& _Out,
+        const _Format _Fmt, const conv2d_options& _Options = {}) {
+        _Conv2d(&_Pool, _In, _Kernel, _Out, _Fmt, _Options, true);
+    }
+} // namespace std
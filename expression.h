@@ -0,0 +1,355 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include <algorithm>
+#include <functional>
+
+namespace std {
+    // Lazy elementwise arithmetic. +, -, * and / on mdspans, expressions and arithmetic scalars build an expression
+    // tree holding the operands by value (mdspans are views, so nothing is copied), and evaluate_into computes the
+    // whole tree in one pass over the destination, with no temporaries.
+
+    struct _Md_expression_base {};
+
+    template <class _Ty>
+    inline constexpr bool _Is_mdspan_v = false;
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    inline constexpr bool _Is_mdspan_v<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>> = true;
+
+    template <class _Ty>
+    inline constexpr bool _Is_md_node_v = _Is_mdspan_v<_Ty> || is_base_of_v<_Md_expression_base, _Ty>;
+
+    template <class _Ty>
+    inline constexpr bool _Is_md_operand_v = _Is_md_node_v<_Ty> || is_arithmetic_v<_Ty>;
+
+    // True if every mapping of _Layout has stride 0 along _Dim, so that elements repeat all along it.
+    template <class _Layout, size_t _Dim>
+    inline constexpr bool _Md_repeats_along_v = false;
+
+    template <class _BaseLayout, size_t... _Dims, size_t _Dim>
+    inline constexpr bool _Md_repeats_along_v<layout_broadcast<_BaseLayout, _Dims...>, _Dim> = ((_Dim == _Dims) || ...);
+
+    template <class _Ty>
+    class _Md_scalar;
+
+    // An mdspan operand.
+    template <class _Span>
+    class _Md_leaf : public _Md_expression_base {
+    public:
+        using value_type = typename _Span::value_type;
+        static constexpr size_t _Rank = _Span::rank();
+
+        explicit constexpr _Md_leaf(const _Span& _Span_) : _View(_Span_), _Acc(_Span_.accessor()) {}
+
+        template <class... _Indices>
+        _NODISCARD constexpr value_type operator()(const _Indices... _Idx) const {
+            return _Acc.access(_View.data(), _View.mapping()(_Idx...));
+        }
+
+        // The operand over a run of indices that differ only in dimension _Inner, starting at _Idx. If the layout
+        // repeats elements along _Inner, that is the one element, read here once instead of once per index.
+        template <size_t _Inner>
+        _NODISCARD constexpr auto _Row(const array<size_t, _Rank>& _Idx) const {
+            if constexpr (_Md_repeats_along_v<typename _Span::layout_type, _Inner>) {
+                return _Md_scalar<value_type>{_Load(_Idx, make_index_sequence<_Rank>{})};
+            } else {
+                return *this;
+            }
+        }
+
+        _NODISCARD constexpr value_type _At(const size_t _Offset) const {
+            return _Acc.access(_View.data(), _Offset);
+        }
+
+        template <class _Extents>
+        _NODISCARD constexpr bool _Matches(const _Extents& _Ext) const {
+            if constexpr (_Rank != 0) {
+                for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                    if (_View.extent(_Dim) != _Ext.extent(_Dim)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // True if offset k of this operand holds the same element as offset k of a destination mapped by _Map.
+        template <class _Mapping>
+        _NODISCARD constexpr bool _Flat_compatible(const _Mapping& _Map) const {
+            if constexpr (is_same_v<_Mapping, typename _Span::mapping_type>) {
+                return _View.mapping() == _Map;
+            } else {
+                return false;
+            }
+        }
+
+    private:
+        template <size_t... _Seq>
+        _NODISCARD constexpr value_type _Load(const array<size_t, _Rank>& _Idx, index_sequence<_Seq...>) const {
+            return _Acc.access(_View.data(), _View.mapping()(_Idx[_Seq]...));
+        }
+
+        _Span _View;
+        typename _Span::accessor_type _Acc;
+    };
+
+    // A scalar operand, the same at every index.
+    template <class _Ty>
+    class _Md_scalar : public _Md_expression_base {
+    public:
+        using value_type = _Ty;
+        static constexpr size_t _Rank = 0;
+
+        explicit constexpr _Md_scalar(const _Ty _Val_) noexcept : _Val(_Val_) {}
+
+        template <class... _Indices>
+        _NODISCARD constexpr value_type operator()(_Indices...) const noexcept {
+            return _Val;
+        }
+
+        _NODISCARD constexpr value_type _At(size_t) const noexcept {
+            return _Val;
+        }
+
+        template <size_t _Inner, size_t _Idx_rank>
+        _NODISCARD constexpr _Md_scalar _Row(const array<size_t, _Idx_rank>&) const noexcept {
+            return *this;
+        }
+
+        template <class _Extents>
+        _NODISCARD constexpr bool _Matches(const _Extents&) const noexcept {
+            return true;
+        }
+
+        template <class _Mapping>
+        _NODISCARD constexpr bool _Flat_compatible(const _Mapping&) const noexcept {
+            return true;
+        }
+
+    private:
+        _Ty _Val;
+    };
+
+    template <class _Op, class _Arg>
+    class _Md_unary : public _Md_expression_base {
+    public:
+        using value_type = decltype(_Op{}(_STD declval<typename _Arg::value_type>()));
+        static constexpr size_t _Rank = _Arg::_Rank;
+
+        explicit constexpr _Md_unary(const _Arg& _Arg_) : _Operand(_Arg_) {}
+
+        template <class... _Indices>
+        _NODISCARD constexpr value_type operator()(const _Indices... _Idx) const {
+            return _Op{}(_Operand(_Idx...));
+        }
+
+        _NODISCARD constexpr value_type _At(const size_t _Offset) const {
+            return _Op{}(_Operand._At(_Offset));
+        }
+
+        template <size_t _Inner, size_t _Idx_rank>
+        _NODISCARD constexpr auto _Row(const array<size_t, _Idx_rank>& _Idx) const {
+            using _Row_arg = decltype(_Operand.template _Row<_Inner>(_Idx));
+            return _Md_unary<_Op, _Row_arg>{_Operand.template _Row<_Inner>(_Idx)};
+        }
+
+        template <class _Extents>
+        _NODISCARD constexpr bool _Matches(const _Extents& _Ext) const {
+            return _Operand._Matches(_Ext);
+        }
+
+        template <class _Mapping>
+        _NODISCARD constexpr bool _Flat_compatible(const _Mapping& _Map) const {
+            return _Operand._Flat_compatible(_Map);
+        }
+
+    private:
+        _Arg _Operand;
+    };
+
+    template <class _Op, class _Left, class _Right>
+    class _Md_binary : public _Md_expression_base {
+    public:
+        static_assert(_Left::_Rank == _Right::_Rank || _Left::_Rank == 0 || _Right::_Rank == 0,
+            "Elementwise operands must have the same rank.");
+
+        using value_type =
+            decltype(_Op{}(_STD declval<typename _Left::value_type>(), _STD declval<typename _Right::value_type>()));
+        static constexpr size_t _Rank = (_STD max)(_Left::_Rank, _Right::_Rank);
+
+        constexpr _Md_binary(const _Left& _Left_, const _Right& _Right_) : _Lhs(_Left_), _Rhs(_Right_) {}
+
+        template <class... _Indices>
+        _NODISCARD constexpr value_type operator()(const _Indices... _Idx) const {
+            return _Op{}(_Lhs(_Idx...), _Rhs(_Idx...));
+        }
+
+        _NODISCARD constexpr value_type _At(const size_t _Offset) const {
+            return _Op{}(_Lhs._At(_Offset), _Rhs._At(_Offset));
+        }
+
+        template <size_t _Inner, size_t _Idx_rank>
+        _NODISCARD constexpr auto _Row(const array<size_t, _Idx_rank>& _Idx) const {
+            using _Row_left = decltype(_Lhs.template _Row<_Inner>(_Idx));
+            using _Row_right = decltype(_Rhs.template _Row<_Inner>(_Idx));
+            return _Md_binary<_Op, _Row_left, _Row_right>{
+                _Lhs.template _Row<_Inner>(_Idx), _Rhs.template _Row<_Inner>(_Idx)};
+        }
+
+        template <class _Extents>
+        _NODISCARD constexpr bool _Matches(const _Extents& _Ext) const {
+            return _Lhs._Matches(_Ext) && _Rhs._Matches(_Ext);
+        }
+
+        template <class _Mapping>
+        _NODISCARD constexpr bool _Flat_compatible(const _Mapping& _Map) const {
+            return _Lhs._Flat_compatible(_Map) && _Rhs._Flat_compatible(_Map);
+        }
+
+    private:
+        _Left _Lhs;
+        _Right _Rhs;
+    };
+
+    template <class _Ty>
+    _NODISCARD constexpr auto _Md_wrap(const _Ty& _Val) {
+        if constexpr (_Is_mdspan_v<_Ty>) {
+            return _Md_leaf<_Ty>{_Val};
+        } else if constexpr (is_arithmetic_v<_Ty>) {
+            return _Md_scalar<_Ty>{_Val};
+        } else {
+            return _Val;
+        }
+    }
+
+    template <class _Left, class _Right>
+    inline constexpr bool _Md_binary_operands_v =
+        _Is_md_operand_v<_Left> && _Is_md_operand_v<_Right> && (_Is_md_node_v<_Left> || _Is_md_node_v<_Right>);
+
+    template <class _Op, class _Left, class _Right>
+    _NODISCARD constexpr auto _Md_make_binary(const _Left& _Lhs, const _Right& _Rhs) {
+        using _Left_node = decltype(_Md_wrap(_Lhs));
+        using _Right_node = decltype(_Md_wrap(_Rhs));
+        return _Md_binary<_Op, _Left_node, _Right_node>{_Md_wrap(_Lhs), _Md_wrap(_Rhs)};
+    }
+
+    template <class _Left, class _Right, enable_if_t<_Md_binary_operands_v<_Left, _Right>, int> = 0>
+    _NODISCARD constexpr auto operator+(const _Left& _Lhs, const _Right& _Rhs) {
+        return _Md_make_binary<plus<>>(_Lhs, _Rhs);
+    }
+
+    template <class _Left, class _Right, enable_if_t<_Md_binary_operands_v<_Left, _Right>, int> = 0>
+    _NODISCARD constexpr auto operator-(const _Left& _Lhs, const _Right& _Rhs) {
+        return _Md_make_binary<minus<>>(_Lhs, _Rhs);
+    }
+
+    template <class _Left, class _Right, enable_if_t<_Md_binary_operands_v<_Left, _Right>, int> = 0>
+    _NODISCARD constexpr auto operator*(const _Left& _Lhs, const _Right& _Rhs) {
+        return _Md_make_binary<multiplies<>>(_Lhs, _Rhs);
+    }
+
+    template <class _Left, class _Right, enable_if_t<_Md_binary_operands_v<_Left, _Right>, int> = 0>
+    _NODISCARD constexpr auto operator/(const _Left& _Lhs, const _Right& _Rhs) {
+        return _Md_make_binary<divides<>>(_Lhs, _Rhs);
+    }
+
+    template <class _Arg, enable_if_t<_Is_md_node_v<_Arg>, int> = 0>
+    _NODISCARD constexpr auto operator-(const _Arg& _Val) {
+        using _Node = decltype(_Md_wrap(_Val));
+        return _Md_unary<negate<>, _Node>{_Md_wrap(_Val)};
+    }
+
+    template <class _Accessor, class _Mapping, class _Node, size_t _Rank, size_t... _Seq>
+    constexpr void _Md_assign_at(const _Accessor& _Acc, const typename _Accessor::pointer& _Ptr, const _Mapping& _Map,
+        const _Node& _Ex, const array<size_t, _Rank>& _Idx, index_sequence<_Seq...>) {
+        _Acc.access(_Ptr, _Map(_Idx[_Seq]...)) = _Ex(_Idx[_Seq]...);
+    }
+
+    // The index walk of evaluate_into, with dimension _Inner innermost and the other dimensions in _Order. Each run
+    // along _Inner evaluates the node's _Row, in which operands repeated along _Inner have already been read.
+    template <size_t _Inner, class _Span, class _Node, size_t _Rank>
+    void _Md_evaluate_rows(const _Span& _Dst, const _Node& _Ex, const array<size_t, _Rank>& _Order) {
+        const auto _Map = _Dst.mapping();
+        const auto _Acc = _Dst.accessor();
+        const auto _Ptr = _Dst.data();
+        const size_t _Inner_extent = _Dst.extent(_Inner);
+        array<size_t, _Rank> _Idx{};
+        for (;;) {
+            const auto _Row = _Ex.template _Row<_Inner>(_Idx);
+            for (_Idx[_Inner] = 0; _Idx[_Inner] < _Inner_extent; ++_Idx[_Inner]) {
+                _Md_assign_at(_Acc, _Ptr, _Map, _Row, _Idx, make_index_sequence<_Rank>{});
+            }
+            _Idx[_Inner] = 0;
+
+            size_t _Level = _Rank - 1;
+            for (; _Level > 0; --_Level) {
+                const size_t _Dim = _Order[_Level - 1];
+                if (++_Idx[_Dim] < _Dst.extent(_Dim)) {
+                    break;
+                }
+                _Idx[_Dim] = 0;
+            }
+            if (_Level == 0) {
+                return;
+            }
+        }
+    }
+
+    // Calls _Md_evaluate_rows with the last dimension of _Order, which is only known at run time, as _Inner.
+    template <class _Span, class _Node, size_t _Rank, size_t... _Dims>
+    void _Md_evaluate_along(
+        const _Span& _Dst, const _Node& _Ex, const array<size_t, _Rank>& _Order, index_sequence<_Dims...>) {
+        const size_t _Inner = _Order[_Rank - 1];
+        (void) ((_Inner == _Dims && (_Md_evaluate_rows<_Dims>(_Dst, _Ex, _Order), true)) || ...);
+    }
+
+    // _Dst(i...) = _Expr(i...) for every index of _Dst. When the destination and every mdspan operand share one
+    // exhaustive, unique mapping, this is a single loop over offsets; otherwise the indices are walked with the
+    // destination's smallest stride innermost, and operands broadcast along that dimension are read once per row.
+    // _Dst may also appear as an operand.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _Expr,
+        enable_if_t<_Is_md_operand_v<_Expr>, int> = 0>
+    void evaluate_into(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _Dst, const _Expr& _Ex) {
+        constexpr size_t _Rank = _Extents::rank();
+        const auto _Node = _Md_wrap(_Ex);
+        static_assert(decltype(_Node)::_Rank == _Rank || decltype(_Node)::_Rank == 0,
+            "The expression and destination ranks differ.");
+        _STL_VERIFY(_Node._Matches(_Dst.extents()), "The expression and destination extents differ.");
+
+        using _Dst_mapping = typename _LayoutPolicy::template mapping<_Extents>;
+        const _Dst_mapping _Map = _Dst.mapping();
+        const auto _Acc = _Dst.accessor();
+        const auto _Ptr = _Dst.data();
+        if constexpr (_Rank == 0) {
+            _Acc.access(_Ptr, _Map()) = _Node();
+        } else {
+            if (_Map.is_exhaustive() && _Map.is_unique() && _Node._Flat_compatible(_Map)) {
+                const auto _Size = static_cast<size_t>(_Map.required_span_size());
+                for (size_t _Offset = 0; _Offset < _Size; ++_Offset) {
+                    _Acc.access(_Ptr, _Offset) = _Node._At(_Offset);
+                }
+                return;
+            }
+
+            array<size_t, _Rank> _Order{};
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _Order[_Dim] = _Dim;
+                if (_Dst.extent(_Dim) == 0) {
+                    return;
+                }
+            }
+
+            if constexpr (_Dst_mapping::is_always_strided()) {
+                _STD stable_sort(_Order.begin(), _Order.end(), [&_Map](const size_t _Left, const size_t _Right) {
+                    return _Map.stride(_Left) > _Map.stride(_Right);
+                });
+            }
+
+            _Md_evaluate_along(_Dst, _Node, _Order, make_index_sequence<_Rank>{});
+        }
+    }
+} // namespace std
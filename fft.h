@@ -0,0 +1,343 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "lines.h"
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <numbers>
+#include <vector>
+
+namespace std {
+    // Fast Fourier transforms along the axes of strided mdspans, in place. Every line along the axis is
+    // transformed; a line's elements are found from the mapping's strides, so no layout needs copying into a
+    // contiguous array first, and lines are gathered as _Md_each_line does. Power-of-two lengths use radix 2;
+    // other lengths use Bluestein's algorithm. The backward transform divides by the length, so it inverts the
+    // forward one.
+
+    enum class fft_direction { forward, backward };
+
+    template <class _Ty>
+    class _Fft_plan {
+    public:
+        _Fft_plan(const size_t _Size_, const bool _Inverse_) : _Size(_Size_), _Inverse(_Inverse_) {
+            _Pow2 = 1;
+            while (_Pow2 < _Size) {
+                _Pow2 <<= 1;
+            }
+            if (_Pow2 != _Size) {
+                // Bluestein: a length-_Size transform as a circular convolution of length >= 2 * _Size - 1.
+                while (_Pow2 < 2 * _Size - 1) {
+                    _Pow2 <<= 1;
+                }
+            }
+
+            _Twiddles.resize(_Pow2 / 2);
+            for (size_t _Idx = 0; _Idx < _Twiddles.size(); ++_Idx) {
+                _Twiddles[_Idx] =
+                    _STD polar(_Ty{1}, -2 * _STD numbers::pi_v<_Ty> * static_cast<_Ty>(_Idx) / static_cast<_Ty>(_Pow2));
+            }
+            _Bitrev.resize(_Pow2);
+            for (size_t _Idx = 1, _Rev = 0; _Idx < _Pow2; ++_Idx) {
+                size_t _Bit = _Pow2 >> 1;
+                for (; _Rev & _Bit; _Bit >>= 1) {
+                    _Rev ^= _Bit;
+                }
+                _Rev |= _Bit;
+                _Bitrev[_Idx] = _Rev;
+            }
+
+            if (_Pow2 != _Size) {
+                const _Ty _Sign = _Inverse ? _Ty{1} : _Ty{-1};
+                _Chirp.resize(_Size);
+                for (size_t _Idx = 0; _Idx < _Size; ++_Idx) {
+                    // k^2 mod 2n keeps the angle small for long transforms.
+                    const size_t _Square = (_Idx * _Idx) % (2 * _Size);
+                    _Chirp[_Idx] = _STD polar(
+                        _Ty{1}, _Sign * _STD numbers::pi_v<_Ty> * static_cast<_Ty>(_Square) / static_cast<_Ty>(_Size));
+                }
+                _Chirp_fft.assign(_Pow2, complex<_Ty>{});
+                _Chirp_fft[0] = _STD conj(_Chirp[0]);
+                for (size_t _Idx = 1; _Idx < _Size; ++_Idx) {
+                    _Chirp_fft[_Idx] = _Chirp_fft[_Pow2 - _Idx] = _STD conj(_Chirp[_Idx]);
+                }
+                _Radix2(_Chirp_fft.data(), false);
+            }
+        }
+
+        _NODISCARD size_t _Scratch_size() const noexcept {
+            return _Pow2 == _Size ? 0 : _Pow2;
+        }
+
+        // Transforms _Size contiguous elements at _Data; _Scratch holds _Scratch_size() elements.
+        void _Run(complex<_Ty>* const _Data, complex<_Ty>* const _Scratch) const {
+            if (_Pow2 == _Size) {
+                _Radix2(_Data, _Inverse);
+            } else {
+                for (size_t _Idx = 0; _Idx < _Size; ++_Idx) {
+                    _Scratch[_Idx] = _Data[_Idx] * _Chirp[_Idx];
+                }
+                _STD fill(_Scratch + _Size, _Scratch + _Pow2, complex<_Ty>{});
+                _Radix2(_Scratch, false);
+                for (size_t _Idx = 0; _Idx < _Pow2; ++_Idx) {
+                    _Scratch[_Idx] *= _Chirp_fft[_Idx];
+                }
+                _Radix2(_Scratch, true);
+                const _Ty _Scale = _Ty{1} / static_cast<_Ty>(_Pow2);
+                for (size_t _Idx = 0; _Idx < _Size; ++_Idx) {
+                    _Data[_Idx] = _Scratch[_Idx] * _Chirp[_Idx] * _Scale;
+                }
+            }
+
+            if (_Inverse) {
+                const _Ty _Scale = _Ty{1} / static_cast<_Ty>(_Size);
+                for (size_t _Idx = 0; _Idx < _Size; ++_Idx) {
+                    _Data[_Idx] *= _Scale;
+                }
+            }
+        }
+
+    private:
+        // Unnormalized iterative radix-2 transform of _Pow2 elements.
+        void _Radix2(complex<_Ty>* const _Data, const bool _Conjugate) const {
+            for (size_t _Idx = 1; _Idx < _Pow2; ++_Idx) {
+                if (_Idx < _Bitrev[_Idx]) {
+                    _STD swap(_Data[_Idx], _Data[_Bitrev[_Idx]]);
+                }
+            }
+
+            for (size_t _Len = 2; _Len <= _Pow2; _Len <<= 1) {
+                const size_t _Half = _Len / 2;
+                const size_t _Step = _Pow2 / _Len;
+                for (size_t _First = 0; _First < _Pow2; _First += _Len) {
+                    for (size_t _Idx = 0; _Idx < _Half; ++_Idx) {
+                        const auto _Twiddle =
+                            _Conjugate ? _STD conj(_Twiddles[_Idx * _Step]) : _Twiddles[_Idx * _Step];
+                        const auto _Even = _Data[_First + _Idx];
+                        const auto _Odd = _Data[_First + _Idx + _Half] * _Twiddle;
+                        _Data[_First + _Idx] = _Even + _Odd;
+                        _Data[_First + _Idx + _Half] = _Even - _Odd;
+                    }
+                }
+            }
+        }
+
+        size_t _Size;
+        size_t _Pow2;
+        bool _Inverse;
+        vector<complex<_Ty>> _Twiddles;
+        vector<size_t> _Bitrev;
+        vector<complex<_Ty>> _Chirp;
+        vector<complex<_Ty>> _Chirp_fft;
+    };
+
+    template <class _Ty>
+    inline constexpr bool _Is_complex_v = false;
+
+    template <class _Ty>
+    inline constexpr bool _Is_complex_v<complex<_Ty>> = true;
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    void _Fft_axis(work_stealing_pool* const _Pool,
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Axis,
+        const fft_direction _Direction) {
+        using _Span = mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>;
+        static_assert(_Is_complex_v<_ElementType>, "FFTs operate on mdspans of std::complex.");
+        static_assert(_Span::is_always_strided(), "FFTs require a strided layout.");
+        static_assert(is_same_v<typename _AccessorPolicy::reference, _ElementType&>,
+            "FFTs require an accessor whose references are plain element references.");
+        using _Ty = typename _ElementType::value_type;
+
+        _STL_VERIFY(_Axis < _Extents::rank(), "FFT axis out of range.");
+        const size_t _Length = _View.extent(_Axis);
+        for (size_t _Dim = 0; _Dim < _Extents::rank(); ++_Dim) {
+            if (_View.extent(_Dim) == 0) {
+                return;
+            }
+        }
+        if (_Length <= 1) {
+            return;
+        }
+
+        const _Fft_plan<_Ty> _Plan(_Length, _Direction == fft_direction::backward);
+        _Md_each_line<true>(
+            _Pool, _View, _Axis, [&_Plan] { return vector<complex<_Ty>>(_Plan._Scratch_size()); },
+            [&_Plan](size_t, complex<_Ty>* const _Data, vector<complex<_Ty>>& _Scratch) {
+                _Plan._Run(_Data, _Scratch.data());
+            });
+    }
+
+    // Transforms every line of _View along _Axis.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    void fft(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Axis,
+        const fft_direction _Direction = fft_direction::forward) {
+        _Fft_axis(nullptr, _View, _Axis, _Direction);
+    }
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    void fft(work_stealing_pool& _Pool, const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View,
+        const size_t _Axis, const fft_direction _Direction = fft_direction::forward) {
+        _Fft_axis(&_Pool, _View, _Axis, _Direction);
+    }
+
+    // The rank-dimensional transform: every axis in turn.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    void fft(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View,
+        const fft_direction _Direction = fft_direction::forward) {
+        for (size_t _Axis = 0; _Axis < _Extents::rank(); ++_Axis) {
+            _Fft_axis(nullptr, _View, _Axis, _Direction);
+        }
+    }
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    void fft(work_stealing_pool& _Pool, const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View,
+        const fft_direction _Direction = fft_direction::forward) {
+        for (size_t _Axis = 0; _Axis < _Extents::rank(); ++_Axis) {
+            _Fft_axis(&_Pool, _View, _Axis, _Direction);
+        }
+    }
+
+    template <class _InSpan, class _OutSpan>
+    void _Rfft_axis(work_stealing_pool* const _Pool, const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis) {
+        using _Ty = typename _InSpan::value_type;
+        static_assert(is_floating_point_v<_Ty>, "Real-to-complex FFTs read floating-point mdspans.");
+        static_assert(is_same_v<typename _OutSpan::value_type, complex<_Ty>>,
+            "Real-to-complex FFTs write mdspans of std::complex of the input type.");
+        static_assert(_InSpan::rank() == _OutSpan::rank(), "FFT input and output ranks differ.");
+        static_assert(_InSpan::is_always_strided() && _OutSpan::is_always_strided(), "FFTs require strided layouts.");
+
+        _STL_VERIFY(_Axis < _InSpan::rank(), "FFT axis out of range.");
+        const size_t _Length = _In.extent(_Axis);
+        for (size_t _Dim = 0; _Dim < _InSpan::rank(); ++_Dim) {
+            _STL_VERIFY(_Out.extent(_Dim) == (_Dim == _Axis ? _Length / 2 + 1 : _In.extent(_Dim)),
+                "Real-to-complex FFT output must match the input, with n / 2 + 1 elements along the axis.");
+            if (_In.extent(_Dim) == 0) {
+                return;
+            }
+        }
+
+        // An even-length real line is transformed as a complex line of half the length, pairing neighbors.
+        const bool _Halved = _Length % 2 == 0;
+        const size_t _Inner = _Halved ? _Length / 2 : _Length;
+        const _Fft_plan<_Ty> _Plan(_Inner, false);
+        vector<complex<_Ty>> _Unpack;
+        if (_Halved) {
+            _Unpack.resize(_Inner + 1);
+            for (size_t _Idx = 0; _Idx <= _Inner; ++_Idx) {
+                _Unpack[_Idx] = _STD polar(
+                    _Ty{1}, -2 * _STD numbers::pi_v<_Ty> * static_cast<_Ty>(_Idx) / static_cast<_Ty>(_Length));
+            }
+        }
+
+        const auto _In_map = _In.mapping();
+        const auto _Out_map = _Out.mapping();
+        const size_t _In_stride = _In_map.stride(_Axis);
+        const size_t _Out_stride = _Out_map.stride(_Axis);
+        const _Md_lines _Lines(_In_map, _Axis);
+        const size_t _Bins = _Length / 2 + 1;
+
+        // Visits every (line, position) of a block: along each line when the axis is unit-stride, and otherwise
+        // across the lines, whose bases _Md_lines orders so that neighbors are adjacent in memory.
+        const auto _Each = [](const size_t _Count, const size_t _Extent, const bool _Along, const auto& _Visit) {
+            if (_Along) {
+                for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                    for (size_t _Pos = 0; _Pos < _Extent; ++_Pos) {
+                        _Visit(_Idx, _Pos);
+                    }
+                }
+            } else {
+                for (size_t _Pos = 0; _Pos < _Extent; ++_Pos) {
+                    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                        _Visit(_Idx, _Pos);
+                    }
+                }
+            }
+        };
+
+        _Md_for_lines(_Pool, _Lines._Size(), _Length, [&](const size_t _First, const size_t _Last) {
+            vector<complex<_Ty>> _Buffer(_Inner + _Plan._Scratch_size());
+            complex<_Ty>* const _Scratch = _Buffer.data() + _Inner;
+            vector<_Ty> _Reals(_Md_line_block * _Length);
+            vector<complex<_Ty>> _Spectra(_Md_line_block * _Bins);
+            array<size_t, _Md_line_block> _In_bases{};
+            array<size_t, _Md_line_block> _Out_bases{};
+            for (size_t _Line = _First; _Line < _Last; _Line += _Md_line_block) {
+                const size_t _Count = (_STD min)(_Md_line_block, _Last - _Line);
+                for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                    _In_bases[_Idx] = _Lines._Base(_In_map, _Line + _Idx);
+                    _Out_bases[_Idx] = _Lines._Base(_Out_map, _Line + _Idx);
+                }
+
+                _Each(_Count, _Length, _In_stride == 1, [&](const size_t _Idx, const size_t _Pos) {
+                    _Reals[_Idx * _Length + _Pos] =
+                        _In.accessor().access(_In.data(), _In_bases[_Idx] + _Pos * _In_stride);
+                });
+
+                for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                    const _Ty* const _Real = _Reals.data() + _Idx * _Length;
+                    complex<_Ty>* const _Spectrum = _Spectra.data() + _Idx * _Bins;
+                    if (!_Halved) {
+                        for (size_t _Pos = 0; _Pos < _Length; ++_Pos) {
+                            _Buffer[_Pos] = _Real[_Pos];
+                        }
+                        _Plan._Run(_Buffer.data(), _Scratch);
+                        _STD copy_n(_Buffer.data(), _Bins, _Spectrum);
+                        continue;
+                    }
+
+                    for (size_t _Pos = 0; _Pos < _Inner; ++_Pos) {
+                        _Buffer[_Pos] = {_Real[2 * _Pos], _Real[2 * _Pos + 1]};
+                    }
+                    _Plan._Run(_Buffer.data(), _Scratch);
+                    for (size_t _Pos = 0; _Pos <= _Inner; ++_Pos) {
+                        const auto _Z = _Buffer[_Pos % _Inner];
+                        const auto _Z_mirror = _STD conj(_Buffer[(_Inner - _Pos) % _Inner]);
+                        const auto _Even = (_Z + _Z_mirror) * _Ty{0.5};
+                        const auto _Odd = (_Z - _Z_mirror) * complex<_Ty>{0, _Ty{-0.5}};
+                        _Spectrum[_Pos] = _Even + _Unpack[_Pos] * _Odd;
+                    }
+                }
+
+                _Each(_Count, _Bins, _Out_stride == 1, [&](const size_t _Idx, const size_t _Pos) {
+                    _Out.accessor().access(_Out.data(), _Out_bases[_Idx] + _Pos * _Out_stride) =
+                        _Spectra[_Idx * _Bins + _Pos];
+                });
+            }
+        });
+    }
+
+    // The non-negative-frequency half of the forward transform of real lines along _Axis: _Out has
+    // _In.extent(_Axis) / 2 + 1 elements there and matches _In elsewhere.
+    template <class _InSpan, class _OutSpan>
+    void rfft(const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis) {
+        _Rfft_axis(nullptr, _In, _Out, _Axis);
+    }
+
+    template <class _InSpan, class _OutSpan>
+    void rfft(work_stealing_pool& _Pool, const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis) {
+        _Rfft_axis(&_Pool, _In, _Out, _Axis);
+    }
+
+    // The rank-dimensional real-to-complex transform: rfft along the last axis, then fft of _Out along the others.
+    template <class _InSpan, class _OutSpan>
+    void rfft(const _InSpan& _In, const _OutSpan& _Out) {
+        static_assert(_InSpan::rank() != 0, "Real-to-complex FFTs need at least one axis.");
+        _Rfft_axis(nullptr, _In, _Out, _InSpan::rank() - 1);
+        for (size_t _Axis = 0; _Axis + 1 < _InSpan::rank(); ++_Axis) {
+            _Fft_axis(nullptr, _Out, _Axis, fft_direction::forward);
+        }
+    }
+
+    template <class _InSpan, class _OutSpan>
+    void rfft(work_stealing_pool& _Pool, const _InSpan& _In, const _OutSpan& _Out) {
+        static_assert(_InSpan::rank() != 0, "Real-to-complex FFTs need at least one axis.");
+        _Rfft_axis(&_Pool, _In, _Out, _InSpan::rank() - 1);
+        for (size_t _Axis = 0; _Axis + 1 < _InSpan::rank(); ++_Axis) {
+            _Fft_axis(&_Pool, _Out, _Axis, fft_direction::forward);
+        }
+    }
+} // namespace std
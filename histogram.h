@@ -0,0 +1,287 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+namespace std {
+    // N-D histograms: each sample, a scalar of a rank-1 mdspan or a row of a rank-2 one, is binned along every
+    // dimension of a rank-N mdspan of counts, one bin description per dimension, and the counts are added to.
+    // Samples outside any dimension's range are dropped. With a pool, every worker counts into a private flat
+    // histogram, so no count is contended, and the private histograms are summed bin range by bin range with
+    // unit-stride loops the compiler vectorizes. Histograms too large to privatize per worker fall back to
+    // relaxed atomic increments of the counts.
+
+    // Bins of equal width dividing [lo, hi).
+    template <class _Ty>
+    class uniform_bins {
+    public:
+        uniform_bins(const _Ty _Lo_, const _Ty _Hi_, const size_t _Count_) : _Lo(_Lo_), _Hi(_Hi_), _Count(_Count_) {
+            _STL_VERIFY(_Count > 0 && _Lo < _Hi, "Uniform bins need a nonempty range and at least one bin.");
+            if constexpr (is_integral_v<_Ty>) {
+                // Integer samples: a shift or a division when the bins have a whole width.
+                const auto _Range = static_cast<_Unsigned>(static_cast<_Unsigned>(_Hi) - static_cast<_Unsigned>(_Lo));
+                if (_Range % _Count == 0) {
+                    _Width = static_cast<_Unsigned>(_Range / _Count);
+                    _Shift = _STD has_single_bit(_Width) ? _STD countr_zero(_Width) : -1;
+                } else {
+                    _Scale = static_cast<double>(_Count) / static_cast<double>(_Range);
+                }
+            } else {
+                _Scale = static_cast<double>(_Count) / static_cast<double>(_Hi - _Lo);
+            }
+        }
+
+        _NODISCARD size_t size() const noexcept {
+            return _Count;
+        }
+
+        // The bin of _Value, or size() if it is outside [lo, hi).
+        _NODISCARD size_t bin(const _Ty& _Value) const noexcept {
+            if (!(_Value >= _Lo && _Value < _Hi)) {
+                return _Count;
+            }
+            if constexpr (is_integral_v<_Ty>) {
+                const auto _Offset =
+                    static_cast<_Unsigned>(static_cast<_Unsigned>(_Value) - static_cast<_Unsigned>(_Lo));
+                if (_Shift >= 0) {
+                    return static_cast<size_t>(_Offset >> _Shift);
+                }
+                if (_Width != 0) {
+                    return static_cast<size_t>(_Offset / _Width);
+                }
+                return (_STD min)(static_cast<size_t>(static_cast<double>(_Offset) * _Scale), _Count - 1);
+            } else {
+                // Rounding can carry values just below hi into bin count.
+                return (_STD min)(static_cast<size_t>(static_cast<double>(_Value - _Lo) * _Scale), _Count - 1);
+            }
+        }
+
+    private:
+        using _Unsigned = make_unsigned_t<conditional_t<is_integral_v<_Ty>, _Ty, int>>;
+
+        _Ty _Lo;
+        _Ty _Hi;
+        size_t _Count;
+        double _Scale = 0;
+        _Unsigned _Width = 0;
+        int _Shift = -1;
+    };
+
+    // Bins between consecutive edges: bin i is [edges[i], edges[i + 1]).
+    template <class _Ty>
+    class variable_bins {
+    public:
+        explicit variable_bins(vector<_Ty> _Edges_) : _Edges(_STD move(_Edges_)) {
+            _STL_VERIFY(_Edges.size() >= 2, "Variable bins need at least two edges.");
+            _STL_VERIFY(_STD adjacent_find(_Edges.begin(), _Edges.end(), greater_equal<>{}) == _Edges.end(),
+                "Bin edges must be strictly increasing.");
+        }
+
+        _NODISCARD size_t size() const noexcept {
+            return _Edges.size() - 1;
+        }
+
+        _NODISCARD const vector<_Ty>& edges() const noexcept {
+            return _Edges;
+        }
+
+        // The bin of _Value, found by binary search, or size() if it is outside [edges.front(), edges.back()).
+        _NODISCARD size_t bin(const _Ty& _Value) const noexcept {
+            if (!(_Value >= _Edges.front() && _Value < _Edges.back())) {
+                return size();
+            }
+            return static_cast<size_t>(_STD upper_bound(_Edges.begin(), _Edges.end(), _Value) - _Edges.begin()) - 1;
+        }
+
+    private:
+        vector<_Ty> _Edges;
+    };
+
+    // Counts per worker above which workers increment the shared counts atomically instead.
+    inline constexpr size_t _Histogram_private_limit = size_t{1} << 24;
+
+    // Samples per task.
+    inline constexpr size_t _Histogram_grain = size_t{1} << 14;
+
+    inline constexpr size_t _Histogram_outside = static_cast<size_t>(-1);
+
+    template <size_t _Dim, class _SampleSpan>
+    _NODISCARD decltype(auto) _Histogram_coordinate(const _SampleSpan& _Samples, const size_t _Sample) {
+        if constexpr (_SampleSpan::rank() == 1) {
+            return _Samples(_Sample);
+        } else {
+            return _Samples(_Sample, _Dim);
+        }
+    }
+
+    template <class _Bins, class _Ty>
+    _NODISCARD bool _Histogram_step(size_t& _Flat, const _Bins& _Axis, const _Ty& _Value) {
+        const size_t _Bin = _Axis.bin(_Value);
+        _Flat = _Flat * _Axis.size() + _Bin;
+        return _Bin < _Axis.size();
+    }
+
+    // The row-major index of the bin of sample _Sample, or _Histogram_outside.
+    template <class _SampleSpan, size_t... _Dims, class... _Bins>
+    _NODISCARD size_t _Histogram_flat_bin(
+        const _SampleSpan& _Samples, const size_t _Sample, index_sequence<_Dims...>, const _Bins&... _Axes) {
+        size_t _Flat = 0;
+        const bool _Inside =
+            (_Histogram_step(_Flat, _Axes, _Histogram_coordinate<_Dims>(_Samples, _Sample)) && ...);
+        return _Inside ? _Flat : _Histogram_outside;
+    }
+
+    // The offset in _Counts of the bin with row-major index _Flat.
+    template <class _CountSpan, size_t... _Dims>
+    _NODISCARD size_t _Histogram_offset(const _CountSpan& _Counts, size_t _Flat, index_sequence<_Dims...>) {
+        array<size_t, _CountSpan::rank()> _Idx{};
+        for (size_t _Dim = _CountSpan::rank(); _Dim-- > 0;) {
+            _Idx[_Dim] = _Flat % _Counts.extent(_Dim);
+            _Flat /= _Counts.extent(_Dim);
+        }
+        return static_cast<size_t>(_Counts.mapping()(_Idx[_Dims]...));
+    }
+
+    template <class _SampleSpan, class _CountSpan, class... _Bins>
+    void _Histogram(work_stealing_pool* const _Pool, const _SampleSpan& _Samples, const _CountSpan& _Counts,
+        const _Bins&... _Axes) {
+        constexpr size_t _Rank = sizeof...(_Bins);
+        static_assert(_CountSpan::rank() == _Rank, "A histogram needs one bin description per count dimension.");
+        static_assert(_SampleSpan::rank() == 2 || (_SampleSpan::rank() == 1 && _Rank == 1),
+            "Histogram samples are the scalars of a rank-1 mdspan or the rows of a rank-2 one.");
+        using _Count = typename _CountSpan::value_type;
+        using _Seq = make_index_sequence<_Rank>;
+
+        if constexpr (_SampleSpan::rank() == 2) {
+            _STL_VERIFY(_Samples.extent(1) == _Rank, "Histogram samples need one coordinate per count dimension.");
+        }
+        const array<size_t, _Rank> _Sizes{_Axes.size()...};
+        size_t _Total = 1;
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            _STL_VERIFY(_Counts.extent(_Dim) == _Sizes[_Dim], "Count extents differ from the number of bins.");
+            _Total *= _Sizes[_Dim];
+        }
+
+        const size_t _Size = _Samples.extent(0);
+        const auto _Count_into = [&](_Count* const _Hist, const size_t _First, const size_t _Last) {
+            for (size_t _Sample = _First; _Sample < _Last; ++_Sample) {
+                const size_t _Flat = _STD _Histogram_flat_bin(_Samples, _Sample, _Seq{}, _Axes...);
+                if (_Flat != _Histogram_outside) {
+                    ++_Hist[_Flat];
+                }
+            }
+        };
+        const auto _Acc = _Counts.accessor();
+        const auto _Add_to_counts = [&](const size_t _Flat, const _Count _Value) {
+            auto&& _Ref = _Acc.access(_Counts.data(), _STD _Histogram_offset(_Counts, _Flat, _Seq{}));
+            _Ref = static_cast<_Count>(_Ref + _Value);
+        };
+
+        constexpr bool _Plain_reference =
+            is_same_v<typename _CountSpan::reference, typename _CountSpan::element_type&>;
+        if constexpr (_Plain_reference && is_same_v<typename _CountSpan::layout_type, layout_right>) {
+            if (!_Pool) {
+                // The row-major bin index is the offset.
+                _Count_into(&_Acc.access(_Counts.data(), 0), 0, _Size);
+                return;
+            }
+        }
+
+        if (!_Pool) {
+            vector<_Count> _Hist(_Total);
+            _Count_into(_Hist.data(), 0, _Size);
+            for (size_t _Flat = 0; _Flat < _Total; ++_Flat) {
+                if (_Hist[_Flat] != _Count{}) {
+                    _Add_to_counts(_Flat, _Hist[_Flat]);
+                }
+            }
+            return;
+        }
+
+        if constexpr (_Plain_reference && is_integral_v<_Count>) {
+            if (_Total > _Histogram_private_limit / (_Pool->size() + 1)) {
+                parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Size}, array<size_t, 1>{_Histogram_grain},
+                    [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) {
+                        for (size_t _Sample = _Lo[0]; _Sample < _Hi[0]; ++_Sample) {
+                            const size_t _Flat = _STD _Histogram_flat_bin(_Samples, _Sample, _Seq{}, _Axes...);
+                            if (_Flat != _Histogram_outside) {
+                                atomic_ref<_Count>(
+                                    _Acc.access(_Counts.data(), _STD _Histogram_offset(_Counts, _Flat, _Seq{})))
+                                    .fetch_add(1, memory_order_relaxed);
+                            }
+                        }
+                    });
+                return;
+            }
+        }
+
+        // One histogram per worker, and a last one shared by threads outside the pool that help with the tasks.
+        vector<vector<_Count>> _Private(_Pool->size() + 1);
+        mutex _Outside_mtx;
+        parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Size}, array<size_t, 1>{_Histogram_grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) {
+                const size_t _Worker = _Pool->current_worker();
+                if (_Worker < _Pool->size()) {
+                    auto& _Mine = _Private[_Worker];
+                    if (_Mine.empty()) {
+                        _Mine.resize(_Total);
+                    }
+                    _Count_into(_Mine.data(), _Lo[0], _Hi[0]);
+                    return;
+                }
+
+                vector<_Count> _Local(_Total);
+                _Count_into(_Local.data(), _Lo[0], _Hi[0]);
+                lock_guard<mutex> _Lock(_Outside_mtx);
+                auto& _Shared = _Private.back();
+                if (_Shared.empty()) {
+                    _Shared.swap(_Local);
+                } else {
+                    for (size_t _Flat = 0; _Flat < _Total; ++_Flat) {
+                        _Shared[_Flat] += _Local[_Flat];
+                    }
+                }
+            });
+
+        // Sum the private histograms over ranges of bins, then add each range to the counts.
+        parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Total}, array<size_t, 1>{_Histogram_grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) {
+                const size_t _First = _Lo[0];
+                const size_t _Length = _Hi[0] - _First;
+                vector<_Count> _Sum(_Length);
+                for (const auto& _Hist : _Private) {
+                    if (!_Hist.empty()) {
+                        const _Count* const _Src = _Hist.data() + _First;
+                        for (size_t _Idx = 0; _Idx < _Length; ++_Idx) {
+                            _Sum[_Idx] += _Src[_Idx];
+                        }
+                    }
+                }
+                for (size_t _Idx = 0; _Idx < _Length; ++_Idx) {
+                    if (_Sum[_Idx] != _Count{}) {
+                        _Add_to_counts(_First + _Idx, _Sum[_Idx]);
+                    }
+                }
+            });
+    }
+
+    // Adds to _Counts the number of samples of _Samples in each bin.
+    template <class _SampleSpan, class _CountSpan, class... _Bins>
+    void histogram(const _SampleSpan& _Samples, const _CountSpan& _Counts, const _Bins&... _Axes) {
+        _Histogram(nullptr, _Samples, _Counts, _Axes...);
+    }
+
+    template <class _SampleSpan, class _CountSpan, class... _Bins>
+    void histogram(
+        work_stealing_pool& _Pool, const _SampleSpan& _Samples, const _CountSpan& _Counts, const _Bins&... _Axes) {
+        _Histogram(&_Pool, _Samples, _Counts, _Axes...);
+    }
+} // namespace std
@@ -0,0 +1,225 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+
+namespace std {
+    // Batched dense operations on rank-3 mdspans whose dimension 0 is the batch. With the batch innermost
+    // (stride(0) == 1 in every operand, as with layout_left), the loops run over one matrix position at a time
+    // with the batch as the unit-stride inner loop, so small matrices vectorize across the batch. Otherwise each
+    // matrix is processed on its own; the work_stealing_pool overloads split the batch across workers either way.
+
+    struct upper_triangle_t {
+        explicit upper_triangle_t() = default;
+    };
+    inline constexpr upper_triangle_t upper_triangle{};
+
+    struct lower_triangle_t {
+        explicit lower_triangle_t() = default;
+    };
+    inline constexpr lower_triangle_t lower_triangle{};
+
+    template <class... _Spans>
+    _NODISCARD bool _Is_batch_innermost(const _Spans&... _Operands) {
+        if constexpr ((_Spans::is_always_strided() && ...)) {
+            return ((_Operands.stride(0) == 1) && ...);
+        } else {
+            return false;
+        }
+    }
+
+    template <class _ASpan, class _BSpan, class _CSpan>
+    void _Batched_gemm_range(
+        const _ASpan& _A, const _BSpan& _B, const _CSpan& _C, const size_t _First, const size_t _Last) {
+        using _Out_t = typename _CSpan::value_type;
+        const size_t _Rows = _C.extent(1);
+        const size_t _Cols = _C.extent(2);
+        const size_t _Inner = _A.extent(2);
+        if (_Is_batch_innermost(_A, _B, _C)) {
+            for (size_t _Row = 0; _Row < _Rows; ++_Row) {
+                for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                    for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                        _C(_Batch, _Row, _Col) = _Out_t{};
+                    }
+                    for (size_t _Idx = 0; _Idx < _Inner; ++_Idx) {
+                        for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                            _C(_Batch, _Row, _Col) += _A(_Batch, _Row, _Idx) * _B(_Batch, _Idx, _Col);
+                        }
+                    }
+                }
+            }
+        } else {
+            for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                for (size_t _Row = 0; _Row < _Rows; ++_Row) {
+                    for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                        _C(_Batch, _Row, _Col) = _Out_t{};
+                    }
+                    for (size_t _Idx = 0; _Idx < _Inner; ++_Idx) {
+                        const auto _Scale = _A(_Batch, _Row, _Idx);
+                        for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                            _C(_Batch, _Row, _Col) += _Scale * _B(_Batch, _Idx, _Col);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template <class _ASpan, class _XSpan, class _YSpan>
+    void _Batched_gemv_range(
+        const _ASpan& _A, const _XSpan& _X, const _YSpan& _Y, const size_t _First, const size_t _Last) {
+        using _Out_t = typename _YSpan::value_type;
+        const size_t _Rows = _A.extent(1);
+        const size_t _Cols = _A.extent(2);
+        if (_Is_batch_innermost(_A, _X, _Y)) {
+            for (size_t _Row = 0; _Row < _Rows; ++_Row) {
+                for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                    _Y(_Batch, _Row) = _Out_t{};
+                }
+                for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                    for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                        _Y(_Batch, _Row) += _A(_Batch, _Row, _Col) * _X(_Batch, _Col);
+                    }
+                }
+            }
+        } else {
+            for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                for (size_t _Row = 0; _Row < _Rows; ++_Row) {
+                    _Out_t _Sum{};
+                    for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                        _Sum += _A(_Batch, _Row, _Col) * _X(_Batch, _Col);
+                    }
+                    _Y(_Batch, _Row) = _Sum;
+                }
+            }
+        }
+    }
+
+    // Forward (lower) or backward (upper) substitution, one right-hand-side column at a time.
+    template <bool _Lower, class _ASpan, class _BSpan>
+    void _Batched_trsm_range(const _ASpan& _A, const _BSpan& _B, const size_t _First, const size_t _Last) {
+        const size_t _Size = _A.extent(1);
+        const size_t _Cols = _B.extent(2);
+        const auto _Solve_row = [&](const size_t _Step, const auto& _Each_batch) {
+            const size_t _Row = _Lower ? _Step : _Size - 1 - _Step;
+            const size_t _Begin = _Lower ? 0 : _Row + 1;
+            const size_t _End = _Lower ? _Row : _Size;
+            for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                for (size_t _Idx = _Begin; _Idx < _End; ++_Idx) {
+                    _Each_batch([&](const size_t _Batch) {
+                        _B(_Batch, _Row, _Col) -= _A(_Batch, _Row, _Idx) * _B(_Batch, _Idx, _Col);
+                    });
+                }
+                _Each_batch([&](const size_t _Batch) { _B(_Batch, _Row, _Col) /= _A(_Batch, _Row, _Row); });
+            }
+        };
+
+        if (_Is_batch_innermost(_A, _B)) {
+            const auto _All = [_First, _Last](const auto& _Func) {
+                for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                    _Func(_Batch);
+                }
+            };
+            for (size_t _Step = 0; _Step < _Size; ++_Step) {
+                _Solve_row(_Step, _All);
+            }
+        } else {
+            for (size_t _Batch = _First; _Batch < _Last; ++_Batch) {
+                const auto _One = [_Batch](const auto& _Func) { _Func(_Batch); };
+                for (size_t _Step = 0; _Step < _Size; ++_Step) {
+                    _Solve_row(_Step, _One);
+                }
+            }
+        }
+    }
+
+    template <class _ASpan, class _BSpan, class _CSpan>
+    void _Verify_batched_gemm(const _ASpan& _A, const _BSpan& _B, const _CSpan& _C) {
+        static_assert(_ASpan::rank() == 3 && _BSpan::rank() == 3 && _CSpan::rank() == 3,
+            "Batched GEMM requires rank-3 operands.");
+        _STL_VERIFY(_A.extent(0) == _C.extent(0) && _B.extent(0) == _C.extent(0), "Batch extents mismatch.");
+        _STL_VERIFY(_A.extent(1) == _C.extent(1) && _A.extent(2) == _B.extent(1) && _B.extent(2) == _C.extent(2),
+            "Batched GEMM matrix extents mismatch.");
+    }
+
+    template <class _ASpan, class _XSpan, class _YSpan>
+    void _Verify_batched_gemv(const _ASpan& _A, const _XSpan& _X, const _YSpan& _Y) {
+        static_assert(_ASpan::rank() == 3 && _XSpan::rank() == 2 && _YSpan::rank() == 2,
+            "Batched GEMV requires a rank-3 matrix and rank-2 vectors.");
+        _STL_VERIFY(_X.extent(0) == _A.extent(0) && _Y.extent(0) == _A.extent(0), "Batch extents mismatch.");
+        _STL_VERIFY(_X.extent(1) == _A.extent(2) && _Y.extent(1) == _A.extent(1), "Batched GEMV extents mismatch.");
+    }
+
+    template <class _ASpan, class _BSpan>
+    void _Verify_batched_trsm(const _ASpan& _A, const _BSpan& _B) {
+        static_assert(_ASpan::rank() == 3 && _BSpan::rank() == 3, "Batched TRSM requires rank-3 operands.");
+        _STL_VERIFY(_A.extent(0) == _B.extent(0), "Batch extents mismatch.");
+        _STL_VERIFY(_A.extent(1) == _A.extent(2) && _B.extent(1) == _A.extent(1),
+            "Batched TRSM requires square matrices matching the right-hand sides.");
+    }
+
+    // Batches per task: enough matrix elements to amortize a task, and at least one batch.
+    _NODISCARD inline size_t _Batch_grain(const size_t _Elements_per_batch) noexcept {
+        return (_STD max)(size_t{1}, (size_t{1} << 14) / (_STD max)(size_t{1}, _Elements_per_batch));
+    }
+
+    template <class _Fn>
+    void _Parallel_batches(work_stealing_pool& _Pool, const size_t _Batches, const size_t _Grain, _Fn _Func) {
+        parallel_for_tiles(_Pool, dextents<size_t, 1>{_Batches}, array<size_t, 1>{_Grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) { _Func(_Lo[0], _Hi[0]); });
+    }
+
+    // C[b] = A[b] B[b]
+    template <class _ASpan, class _BSpan, class _CSpan>
+    void batched_gemm(const _ASpan& _A, const _BSpan& _B, const _CSpan& _C) {
+        _Verify_batched_gemm(_A, _B, _C);
+        _Batched_gemm_range(_A, _B, _C, 0, _C.extent(0));
+    }
+
+    template <class _ASpan, class _BSpan, class _CSpan>
+    void batched_gemm(work_stealing_pool& _Pool, const _ASpan& _A, const _BSpan& _B, const _CSpan& _C) {
+        _Verify_batched_gemm(_A, _B, _C);
+        _Parallel_batches(_Pool, _C.extent(0), _Batch_grain(_C.extent(1) * _C.extent(2) * _A.extent(2)),
+            [&](const size_t _First, const size_t _Last) { _Batched_gemm_range(_A, _B, _C, _First, _Last); });
+    }
+
+    // y[b] = A[b] x[b]
+    template <class _ASpan, class _XSpan, class _YSpan>
+    void batched_gemv(const _ASpan& _A, const _XSpan& _X, const _YSpan& _Y) {
+        _Verify_batched_gemv(_A, _X, _Y);
+        _Batched_gemv_range(_A, _X, _Y, 0, _A.extent(0));
+    }
+
+    template <class _ASpan, class _XSpan, class _YSpan>
+    void batched_gemv(work_stealing_pool& _Pool, const _ASpan& _A, const _XSpan& _X, const _YSpan& _Y) {
+        _Verify_batched_gemv(_A, _X, _Y);
+        _Parallel_batches(_Pool, _A.extent(0), _Batch_grain(_A.extent(1) * _A.extent(2)),
+            [&](const size_t _First, const size_t _Last) { _Batched_gemv_range(_A, _X, _Y, _First, _Last); });
+    }
+
+    // Overwrites B[b] with the solution X of A[b] X = B[b], reading only the given triangle of A[b].
+    template <class _ASpan, class _BSpan>
+    void batched_trsm(const _ASpan& _A, upper_triangle_t, const _BSpan& _B) {
+        _Verify_batched_trsm(_A, _B);
+        _Batched_trsm_range<false>(_A, _B, 0, _A.extent(0));
+    }
+
+    template <class _ASpan, class _BSpan>
+    void batched_trsm(const _ASpan& _A, lower_triangle_t, const _BSpan& _B) {
+        _Verify_batched_trsm(_A, _B);
+        _Batched_trsm_range<true>(_A, _B, 0, _A.extent(0));
+    }
+
+    template <class _ASpan, class _Triangle, class _BSpan,
+        enable_if_t<_Is_any_of_v<_Triangle, upper_triangle_t, lower_triangle_t>, int> = 0>
+    void batched_trsm(work_stealing_pool& _Pool, const _ASpan& _A, _Triangle, const _BSpan& _B) {
+        _Verify_batched_trsm(_A, _B);
+        _Parallel_batches(_Pool, _A.extent(0), _Batch_grain(_A.extent(1) * _A.extent(1) * _B.extent(2)),
+            [&](const size_t _First, const size_t _Last) {
+                _Batched_trsm_range<is_same_v<_Triangle, lower_triangle_t>>(_A, _B, _First, _Last);
+            });
+    }
+} // namespace std
@@ -0,0 +1,136 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <vector>
+
+namespace std {
+    // Shared by the algorithms that work on every line of a strided mdspan along one axis independently. A line
+    // along a unit-stride axis is worked on where it is; otherwise a block of neighboring lines is gathered into
+    // contiguous scratch, reading across the lines so each cache line is used fully, and scattered back if the
+    // algorithm writes in place.
+
+    // The lines of an mdspan along _Axis, numbered with the smallest-stride other dimension fastest, so
+    // consecutive lines are neighbors in memory.
+    template <class _Mapping>
+    class _Md_lines {
+    public:
+        static constexpr size_t _Rank = _Mapping::extents_type::rank();
+
+        _Md_lines(const _Mapping& _Map, const size_t _Axis) {
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                if (_Dim != _Axis) {
+                    _Dims[_Others++] = _Dim;
+                }
+            }
+            _STD stable_sort(_Dims.begin(), _Dims.begin() + _Others,
+                [&_Map](const size_t _Left, const size_t _Right) { return _Map.stride(_Left) < _Map.stride(_Right); });
+            for (size_t _Idx = 0; _Idx < _Others; ++_Idx) {
+                _Count *= _Map.extents().extent(_Dims[_Idx]);
+            }
+        }
+
+        _NODISCARD size_t _Size() const noexcept {
+            return _Count;
+        }
+
+        // Offset under _Map of the first element of line _Line. _Map may be another mapping with the same extents
+        // outside the axis.
+        template <class _Other_mapping>
+        _NODISCARD size_t _Base(const _Other_mapping& _Map, size_t _Line) const {
+            size_t _Offset = 0;
+            for (size_t _Idx = 0; _Idx < _Others; ++_Idx) {
+                const size_t _Extent = _Map.extents().extent(_Dims[_Idx]);
+                _Offset += (_Line % _Extent) * _Map.stride(_Dims[_Idx]);
+                _Line /= _Extent;
+            }
+            return _Offset;
+        }
+
+    private:
+        array<size_t, _Rank> _Dims{};
+        size_t _Others = 0;
+        size_t _Count = 1;
+    };
+
+    // Lines to gather at once: enough to fill a cache line of the elements read across them.
+    inline constexpr size_t _Md_line_block = 16;
+
+    // Calls _Func(first, last) over [0, _Lines), split across _Pool if there is one.
+    template <class _Fn>
+    void _Md_for_lines(work_stealing_pool* const _Pool, const size_t _Lines, const size_t _Length, _Fn _Func) {
+        if (!_Pool) {
+            _Func(size_t{0}, _Lines);
+            return;
+        }
+
+        // Around 2^14 elements per task, in whole blocks: the tiling is over block indices, since bisecting the
+        // lines themselves would split them at arbitrary points and leave every gather block partly empty.
+        const size_t _Per_task = (_STD max)(size_t{1}, (size_t{1} << 14) / (_STD max)(size_t{1}, _Length));
+        const size_t _Grain = (_Per_task + _Md_line_block - 1) / _Md_line_block;
+        const size_t _Blocks = (_Lines + _Md_line_block - 1) / _Md_line_block;
+        parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Blocks}, array<size_t, 1>{_Grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) {
+                _Func(_Lo[0] * _Md_line_block, (_STD min)(_Hi[0] * _Md_line_block, _Lines));
+            });
+    }
+
+    // Calls _Func(line, data, state) for every line of _View along _Axis, where data points to the line's elements,
+    // contiguous, and state is made by _Make_state once per task. The lines are scattered back if _Write_back.
+    template <bool _Write_back, class _Span, class _Make, class _Fn>
+    void _Md_each_line(
+        work_stealing_pool* const _Pool, const _Span& _View, const size_t _Axis, _Make _Make_state, _Fn _Func) {
+        static_assert(_Span::is_always_strided(), "Working along an axis requires a strided layout.");
+        constexpr bool _Plain_reference = is_same_v<typename _Span::reference, typename _Span::element_type&>;
+
+        const size_t _Length = _View.extent(_Axis);
+        const auto _Map = _View.mapping();
+        const auto _Acc = _View.accessor();
+        const auto _Ptr = _View.data();
+        const size_t _Stride = _Map.stride(_Axis);
+        const _Md_lines _Lines(_Map, _Axis);
+        if (_Length == 0 || _Lines._Size() == 0) {
+            return;
+        }
+
+        _Md_for_lines(_Pool, _Lines._Size(), _Length, [&](const size_t _First, const size_t _Last) {
+            auto _State = _Make_state();
+            if constexpr (_Plain_reference) {
+                if (_Stride == 1) {
+                    for (size_t _Line = _First; _Line < _Last; ++_Line) {
+                        _Func(_Line, &_Acc.access(_Ptr, _Lines._Base(_Map, _Line)), _State);
+                    }
+                    return;
+                }
+            }
+
+            vector<typename _Span::value_type> _Buffer(_Md_line_block * _Length);
+            array<size_t, _Md_line_block> _Bases;
+            for (size_t _Line = _First; _Line < _Last; _Line += _Md_line_block) {
+                const size_t _Count = (_STD min)(_Md_line_block, _Last - _Line);
+                for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                    _Bases[_Idx] = _Lines._Base(_Map, _Line + _Idx);
+                }
+                for (size_t _Pos = 0; _Pos < _Length; ++_Pos) {
+                    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                        _Buffer[_Idx * _Length + _Pos] = _Acc.access(_Ptr, _Bases[_Idx] + _Pos * _Stride);
+                    }
+                }
+                for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                    _Func(_Line + _Idx, _Buffer.data() + _Idx * _Length, _State);
+                }
+                if constexpr (_Write_back) {
+                    for (size_t _Pos = 0; _Pos < _Length; ++_Pos) {
+                        for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+                            _Acc.access(_Ptr, _Bases[_Idx] + _Pos * _Stride) = _Buffer[_Idx * _Length + _Pos];
+                        }
+                    }
+                }
+            }
+        });
+    }
+} // namespace std
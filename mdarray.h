@@ -0,0 +1,183 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include <utility>
+#include <vector>
+
+namespace std {
+    // An owning multidimensional array: a layout mapping together with a contiguous container holding
+    // required_span_size() elements. _Container needs data(), size(), and, for the constructors that allocate,
+    // construction from a size.
+    template <class _ElementType, class _Extents, class _LayoutPolicy = layout_right,
+        class _Container = vector<_ElementType>>
+    class mdarray {
+    public:
+        using extents_type = _Extents;
+        using layout_type = _LayoutPolicy;
+        using container_type = _Container;
+        using mapping_type = typename layout_type::template mapping<extents_type>;
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<element_type>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = element_type*;
+        using const_pointer = const element_type*;
+        using reference = element_type&;
+        using const_reference = const element_type&;
+        using mdspan_type = mdspan<element_type, extents_type, layout_type>;
+        using const_mdspan_type = mdspan<const element_type, extents_type, layout_type>;
+
+        _NODISCARD static constexpr size_t rank() noexcept {
+            return _Extents::rank();
+        }
+        _NODISCARD static constexpr size_t rank_dynamic() noexcept {
+            return _Extents::rank_dynamic();
+        }
+        _NODISCARD static constexpr size_t static_extent(size_t r) noexcept {
+            return _Extents::static_extent(r);
+        }
+
+        constexpr mdarray()
+#ifdef __cpp_lib_concepts
+            requires(rank_dynamic() == 0)
+#endif
+            : _Map{}, _Ctr(static_cast<size_t>(_Map.required_span_size())) {
+        }
+
+        template <class... _SizeTypes,
+            enable_if_t<(is_convertible_v<_SizeTypes, size_type> && ...) && is_constructible_v<_Extents, _SizeTypes...>
+                && is_constructible_v<mapping_type, _Extents>, int> = 0>
+        explicit constexpr mdarray(_SizeTypes... _Exts)
+            : _Map{_Extents{_Exts...}}, _Ctr(static_cast<size_t>(_Map.required_span_size())) {}
+
+        explicit constexpr mdarray(const _Extents& _Ext)
+            : _Map{_Ext}, _Ctr(static_cast<size_t>(_Map.required_span_size())) {}
+
+        explicit constexpr mdarray(const mapping_type& _Map_)
+            : _Map{_Map_}, _Ctr(static_cast<size_t>(_Map.required_span_size())) {}
+
+        constexpr mdarray(const mapping_type& _Map_, const container_type& _Ctr_) : _Map{_Map_}, _Ctr(_Ctr_) {
+            _STL_VERIFY(_Ctr.size() >= static_cast<size_t>(_Map.required_span_size()),
+                "The container is smaller than the mapping's required span.");
+        }
+
+        constexpr mdarray(const mapping_type& _Map_, container_type&& _Ctr_) : _Map{_Map_}, _Ctr(_STD move(_Ctr_)) {
+            _STL_VERIFY(_Ctr.size() >= static_cast<size_t>(_Map.required_span_size()),
+                "The container is smaller than the mapping's required span.");
+        }
+
+        template <class... _SizeTypes,
+            enable_if_t<(is_convertible_v<_SizeTypes, size_type> && ...) && sizeof...(_SizeTypes) == rank(), int> = 0>
+        _NODISCARD constexpr reference operator()(_SizeTypes... _Indices) {
+            return data()[_Map(_Indices...)];
+        }
+
+        template <class... _SizeTypes,
+            enable_if_t<(is_convertible_v<_SizeTypes, size_type> && ...) && sizeof...(_SizeTypes) == rank(), int> = 0>
+        _NODISCARD constexpr const_reference operator()(_SizeTypes... _Indices) const {
+            return data()[_Map(_Indices...)];
+        }
+
+        template <class _SizeType, size_t _Size, enable_if_t<is_convertible_v<_SizeType, size_type> && _Size == rank(), int> = 0>
+        _NODISCARD constexpr reference operator[](const array<_SizeType, _Size>& _Indices) {
+            return to_mdspan()[_Indices];
+        }
+
+        template <class _SizeType, size_t _Size, enable_if_t<is_convertible_v<_SizeType, size_type> && _Size == rank(), int> = 0>
+        _NODISCARD constexpr const_reference operator[](const array<_SizeType, _Size>& _Indices) const {
+            return to_mdspan()[_Indices];
+        }
+
+        _NODISCARD constexpr _Extents extents() const noexcept {
+            return _Map.extents();
+        }
+
+        _NODISCARD constexpr size_type extent(size_t r) const noexcept {
+            return _Map.extents().extent(r);
+        }
+
+        _NODISCARD constexpr size_type size() const noexcept {
+            const auto& _Ext = _Map.extents();
+            size_type _Result = 1;
+            for (size_t _Dim = 0; _Dim < rank(); ++_Dim) {
+                _Result *= _Ext.extent(_Dim);
+            }
+            return _Result;
+        }
+
+        _NODISCARD constexpr const mapping_type& mapping() const noexcept {
+            return _Map;
+        }
+
+        _NODISCARD constexpr size_type stride(size_t r) const {
+            return _Map.stride(r);
+        }
+
+        _NODISCARD constexpr pointer data() noexcept {
+            return _Ctr.data();
+        }
+
+        _NODISCARD constexpr const_pointer data() const noexcept {
+            return _Ctr.data();
+        }
+
+        _NODISCARD constexpr container_type& container() noexcept {
+            return _Ctr;
+        }
+
+        _NODISCARD constexpr const container_type& container() const noexcept {
+            return _Ctr;
+        }
+
+        _NODISCARD constexpr container_type extract_container() && noexcept {
+            return _STD move(_Ctr);
+        }
+
+        _NODISCARD constexpr mdspan_type to_mdspan() noexcept {
+            return mdspan_type{data(), _Map};
+        }
+
+        _NODISCARD constexpr const_mdspan_type to_mdspan() const noexcept {
+            return const_mdspan_type{data(), _Map};
+        }
+
+        constexpr operator mdspan_type() noexcept {
+            return to_mdspan();
+        }
+
+        constexpr operator const_mdspan_type() const noexcept {
+            return to_mdspan();
+        }
+
+        _NODISCARD static constexpr bool is_always_unique() noexcept {
+            return mapping_type::is_always_unique();
+        }
+
+        _NODISCARD static constexpr bool is_always_exhaustive() noexcept {
+            return mapping_type::is_always_exhaustive();
+        }
+
+        _NODISCARD static constexpr bool is_always_strided() noexcept {
+            return mapping_type::is_always_strided();
+        }
+
+        _NODISCARD constexpr bool is_unique() const {
+            return _Map.is_unique();
+        }
+
+        _NODISCARD constexpr bool is_exhaustive() const {
+            return _Map.is_exhaustive();
+        }
+
+        _NODISCARD constexpr bool is_strided() const {
+            return _Map.is_strided();
+        }
+
+    private:
+        mapping_type _Map;
+        container_type _Ctr;
+    };
+} // namespace std
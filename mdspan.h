@@ -8,6 +8,12 @@
 #include <span>
 #include <tuple>
 
+// Define _MDSPAN_BOUNDS_CHECK to 1 to check every index passed to an mdspan against its extents. With the default
+// of 0 the checks compile away; checked_accessor enables them for individual views.
+#ifndef _MDSPAN_BOUNDS_CHECK
+#define _MDSPAN_BOUNDS_CHECK 0
+#endif
+
 namespace std {
     template <class _IndexType, size_t _Rank_dynamic, size_t... _Extents>
     struct _Mdspan_extent_type {
@@ -27,6 +33,17 @@ namespace std {
             }
             return result;
         }();
+        static constexpr array<size_t, _Rank_dynamic> _Dynamic_positions =
+            []() constexpr {
+            array<size_t, _Rank_dynamic> result{};
+            size_t _Counter = 0;
+            for (size_t i = 0; i < sizeof...(_Extents); ++i) {
+                if (_Static_extents[i] == dynamic_extent) {
+                    result[_Counter++] = i;
+                }
+            }
+            return result;
+        }();
 
         constexpr _Mdspan_extent_type() noexcept = default;
 
@@ -51,7 +68,7 @@ namespace std {
         template <class _OtherIndexType, size_t _Size, size_t..._Idx, enable_if_t<_Size == sizeof...(_Extents)
             && sizeof...(_Extents) != _Rank_dynamic, int> = 0>
         constexpr _Mdspan_extent_type(span<_OtherIndexType, _Size> _Data, index_sequence<_Idx...>) noexcept
-            : _Dynamic_extents({ static_cast<index_type>(_STD as_const(_Data[_Dynamic_indexes[_Idx]]))... })
+            : _Dynamic_extents{ static_cast<index_type>(_STD as_const(_Data[_Dynamic_positions[_Idx]]))... }
         {}
 
         constexpr index_type* _Begin_dynamic_extents() noexcept {
@@ -120,7 +137,13 @@ namespace std {
         }
 
         _NODISCARD static constexpr size_t static_extent(const rank_type _Idx) noexcept {
-            return _Mybase::_Static_extents[_Idx];
+            if constexpr (rank() == 0) {
+                (void) _Idx;
+                return dynamic_extent;
+            }
+            else {
+                return _Mybase::_Static_extents[_Idx];
+            }
         }
 
         _NODISCARD constexpr size_type extent(const rank_type _Idx) const noexcept {
@@ -217,10 +240,16 @@ namespace std {
         }
     };
 
+    template <class _IndexType, class _Seq>
+    struct _Dextents_impl;
+
+    template <class _IndexType, size_t... _Seq>
+    struct _Dextents_impl<_IndexType, index_sequence<_Seq...>> {
+        using type = extents<_IndexType, ((void)_Seq, dynamic_extent)...>;
+    };
+
     template <class _IndexType, size_t _Rank>
-    using dextents = decltype([]<size_t... _Seq>(const index_sequence<_Seq...>) constexpr {
-        return extents<_IndexType, ((void)_Seq, dynamic_extent)...>{};
-    }(make_index_sequence<_Rank>{}));
+    using dextents = typename _Dextents_impl<_IndexType, make_index_sequence<_Rank>>::type;
 
     template <class... _Integrals, enable_if_t<(is_convertible_v<_Integrals, size_t> && ...), int> = 0>
     extents(_Integrals... _Ext) -> extents<size_t, conditional_t<true,
@@ -588,6 +617,435 @@ namespace std {
         }
     };
 
+    // Packed storage of one triangle of a square matrix, in the column-major order used by BLAS and LAPACK
+    // packed routines ('U' and 'L'). Indices on the other side of the diagonal are reflected onto the stored
+    // triangle, so (i, j) and (j, i) map to the same offset and the mapping describes a symmetric matrix.
+    struct layout_packed_upper {
+        template <class _Extents> class mapping;
+    };
+
+    struct layout_packed_lower {
+        template <class _Extents> class mapping;
+    };
+
+    template <class _Layout, class _Extents>
+    class _Packed_mapping {
+    public:
+        using extents_type = _Extents;
+        using index_type = typename _Extents::index_type;
+        using size_type = typename _Extents::size_type;
+        using rank_type = typename _Extents::rank_type;
+        using layout_type = _Layout;
+
+        static_assert(_Extents::rank() == 2, "Packed layouts require rank-2 extents.");
+        static_assert(_Extents::static_extent(0) == dynamic_extent || _Extents::static_extent(1) == dynamic_extent
+            || _Extents::static_extent(0) == _Extents::static_extent(1), "Packed layouts require square extents.");
+
+        constexpr _Packed_mapping() noexcept = default;
+
+        constexpr _Packed_mapping(const _Extents& _Ext) noexcept : _Myext(_Ext) {
+            _STL_VERIFY(_Ext.extent(0) == _Ext.extent(1), "Packed layouts require square extents.");
+        }
+
+        _NODISCARD constexpr _Extents extents() const noexcept {
+            return _Myext;
+        }
+
+        _NODISCARD constexpr size_type required_span_size() const noexcept {
+            const size_type _Size = _Myext.extent(0);
+            return _Size * (_Size + 1) / 2;
+        }
+
+        template <class _Index0, class _Index1,
+            enable_if_t<is_convertible_v<_Index0, index_type> && is_convertible_v<_Index1, index_type>
+            && is_nothrow_constructible_v<index_type, _Index0> && is_nothrow_constructible_v<index_type, _Index1>,
+            int> = 0>
+        _NODISCARD constexpr size_type operator()(_Index0 _Idx0, _Index1 _Idx1) const noexcept {
+            auto _Row = static_cast<size_type>(static_cast<index_type>(_Idx0));
+            auto _Col = static_cast<size_type>(static_cast<index_type>(_Idx1));
+            if constexpr (is_same_v<_Layout, layout_packed_upper>) {
+                if (_Row > _Col) {
+                    _STD swap(_Row, _Col);
+                }
+
+                return _Row + _Col * (_Col + 1) / 2;
+            }
+            else {
+                if (_Row < _Col) {
+                    _STD swap(_Row, _Col);
+                }
+
+                return (_Row - _Col) + _Col * (2 * _Myext.extent(0) - _Col + 1) / 2;
+            }
+        }
+
+        _NODISCARD static constexpr bool is_always_unique() noexcept {
+            return false;
+        }
+        _NODISCARD static constexpr bool is_always_exhaustive() noexcept {
+            return true;
+        }
+        _NODISCARD static constexpr bool is_always_strided() noexcept {
+            return false;
+        }
+
+        _NODISCARD constexpr bool is_unique() const noexcept {
+            return _Myext.extent(0) < 2;
+        }
+        _NODISCARD constexpr bool is_exhaustive() const noexcept {
+            return true;
+        }
+        _NODISCARD constexpr bool is_strided() const noexcept {
+            return false;
+        }
+
+        template <class _OtherExtents>
+        _NODISCARD friend constexpr bool operator==(
+            const _Packed_mapping& _Lhs, const _Packed_mapping<_Layout, _OtherExtents>& _Rhs) noexcept {
+            return _Lhs.extents() == _Rhs.extents();
+        }
+
+    private:
+        _Extents _Myext{};
+    };
+
+    template <class _Extents>
+    class layout_packed_upper::mapping : public _Packed_mapping<layout_packed_upper, _Extents> {
+    public:
+        using _Packed_mapping<layout_packed_upper, _Extents>::_Packed_mapping;
+
+        constexpr mapping() noexcept = default;
+
+        template <class _OtherExtents, enable_if_t<is_constructible_v<_Extents, _OtherExtents>, int> = 0>
+        explicit(!is_convertible_v<_OtherExtents, _Extents>) constexpr mapping(
+            const mapping<_OtherExtents>& _Other) noexcept
+            : _Packed_mapping<layout_packed_upper, _Extents>(_Extents{_Other.extents()}) {}
+    };
+
+    template <class _Extents>
+    class layout_packed_lower::mapping : public _Packed_mapping<layout_packed_lower, _Extents> {
+    public:
+        using _Packed_mapping<layout_packed_lower, _Extents>::_Packed_mapping;
+
+        constexpr mapping() noexcept = default;
+
+        template <class _OtherExtents, enable_if_t<is_constructible_v<_Extents, _OtherExtents>, int> = 0>
+        explicit(!is_convertible_v<_OtherExtents, _Extents>) constexpr mapping(
+            const mapping<_OtherExtents>& _Other) noexcept
+            : _Packed_mapping<layout_packed_lower, _Extents>(_Extents{_Other.extents()}) {}
+    };
+
+    template <size_t... _Perm>
+    inline constexpr bool _Is_permutation_v = [] {
+        constexpr size_t _Values[] = {_Perm..., 0};
+        bool _Seen[sizeof...(_Perm) + 1]{};
+        for (size_t _Idx = 0; _Idx < sizeof...(_Perm); ++_Idx) {
+            if (_Values[_Idx] >= sizeof...(_Perm) || _Seen[_Values[_Idx]]) {
+                return false;
+            }
+            _Seen[_Values[_Idx]] = true;
+        }
+        return true;
+    }();
+
+    template <size_t... _Perm>
+    inline constexpr bool _Is_identity_permutation_v = [] {
+        size_t _Expected = 0;
+        return ((_Perm == _Expected++) && ...);
+    }();
+
+    template <size_t... _Perm>
+    inline constexpr bool _Is_reversal_permutation_v = [] {
+        size_t _Expected = sizeof...(_Perm);
+        return ((_Perm == --_Expected) && ...);
+    }();
+
+    template <class _Seq, size_t... _Perm>
+    struct _Inverse_permutation_impl;
+
+    template <size_t... _Seq, size_t... _Perm>
+    struct _Inverse_permutation_impl<index_sequence<_Seq...>, _Perm...> {
+        static constexpr size_t _Position(const size_t _Value) noexcept {
+            constexpr size_t _Values[] = {_Perm..., 0};
+            size_t _Idx = 0;
+            while (_Idx < sizeof...(_Perm) && _Values[_Idx] != _Value) {
+                ++_Idx;
+            }
+            return _Idx;
+        }
+
+        using type = index_sequence<_Position(_Seq)...>;
+    };
+
+    template <size_t... _Perm>
+    using _Inverse_permutation_t =
+        typename _Inverse_permutation_impl<make_index_sequence<sizeof...(_Perm)>, _Perm...>::type;
+
+    // Extents of type _Extents with extent(i) == _All[i]; the entries for static extents are ignored.
+    template <class _Extents>
+    _NODISCARD constexpr _Extents _Make_extents(
+        const array<typename _Extents::index_type, _Extents::rank()>& _All) noexcept {
+        if constexpr (_Extents::rank_dynamic() == 0) {
+            (void) _All;
+            return _Extents{};
+        } else {
+            array<typename _Extents::index_type, _Extents::rank_dynamic()> _Dynamic{};
+            size_t _Next = 0;
+            for (size_t _Dim = 0; _Dim < _Extents::rank(); ++_Dim) {
+                if (_Extents::static_extent(_Dim) == dynamic_extent) {
+                    _Dynamic[_Next++] = _All[_Dim];
+                }
+            }
+            return _Extents{_Dynamic};
+        }
+    }
+
+    // The extents of dimensions _Dims... of _Extents, in that order, keeping static extents static.
+    template <class _Extents, class _Dims>
+    struct _Pick_extents;
+
+    template <class _IndexType, size_t... _Ext, size_t... _Dims>
+    struct _Pick_extents<extents<_IndexType, _Ext...>, index_sequence<_Dims...>> {
+        using _Source = extents<_IndexType, _Ext...>;
+        using type = extents<_IndexType, _Source::static_extent(_Dims)...>;
+
+        _NODISCARD static constexpr type _Apply([[maybe_unused]] const _Source& _Src) noexcept {
+            return _STD _Make_extents<type>({static_cast<typename type::index_type>(_Src.extent(_Dims))...});
+        }
+    };
+
+    // Dimension i of layout_permuted<_BaseLayout, _Perm...> is dimension _Perm[i] of an underlying _BaseLayout
+    // mapping, so a transpose or axis swap moves no data. Uniqueness, exhaustiveness and strides are the base
+    // mapping's, which keeps a permuted layout_right known to be contiguous where layout_stride would not be.
+    template <class _BaseLayout, size_t... _Perm>
+    struct layout_permuted {
+        static_assert(_Is_permutation_v<_Perm...>, "layout_permuted requires a permutation of 0, ..., rank - 1.");
+
+        template <class _Extents> class mapping;
+    };
+
+    template <class _BaseLayout, size_t... _Perm>
+    template <class _Extents>
+    class layout_permuted<_BaseLayout, _Perm...>::mapping {
+    public:
+        using extents_type = _Extents;
+        using index_type = typename _Extents::index_type;
+        using size_type = typename _Extents::size_type;
+        using rank_type = typename _Extents::rank_type;
+        using layout_type = layout_permuted;
+
+        static_assert(sizeof...(_Perm) == _Extents::rank(), "The permutation and extents ranks differ.");
+
+        using _Inverse = _Inverse_permutation_t<_Perm...>;
+        using base_mapping_type =
+            typename _BaseLayout::template mapping<typename _Pick_extents<_Extents, _Inverse>::type>;
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const mapping&) noexcept = default;
+
+        constexpr mapping(const _Extents& _Ext)
+            : _Myext(_Ext), _Base(_Pick_extents<_Extents, _Inverse>::_Apply(_Ext)) {}
+
+        explicit constexpr mapping(const base_mapping_type& _Base_)
+            : _Myext(_Pick_extents<typename base_mapping_type::extents_type, index_sequence<_Perm...>>::_Apply(
+                _Base_.extents())),
+              _Base(_Base_) {}
+
+        constexpr mapping& operator=(const mapping&) noexcept = default;
+
+        _NODISCARD constexpr _Extents extents() const noexcept {
+            return _Myext;
+        }
+
+        _NODISCARD constexpr const base_mapping_type& base_mapping() const noexcept {
+            return _Base;
+        }
+
+        _NODISCARD constexpr size_type required_span_size() const noexcept {
+            return static_cast<size_type>(_Base.required_span_size());
+        }
+
+        template <class... _Indices,
+            enable_if_t<sizeof...(_Indices) == _Extents::rank() && (is_convertible_v<_Indices, index_type> && ...)
+            && (is_nothrow_constructible_v<index_type, _Indices> && ...),
+            int> = 0>
+        _NODISCARD constexpr size_type operator()(_Indices... _Idx) const noexcept {
+            return _Index_impl(array<index_type, _Extents::rank()>{static_cast<index_type>(_Idx)...}, _Inverse{});
+        }
+
+        _NODISCARD static constexpr bool is_always_unique() noexcept {
+            return base_mapping_type::is_always_unique();
+        }
+        _NODISCARD static constexpr bool is_always_exhaustive() noexcept {
+            return base_mapping_type::is_always_exhaustive();
+        }
+        _NODISCARD static constexpr bool is_always_strided() noexcept {
+            return base_mapping_type::is_always_strided();
+        }
+
+        _NODISCARD constexpr bool is_unique() const noexcept {
+            return _Base.is_unique();
+        }
+        _NODISCARD constexpr bool is_exhaustive() const noexcept {
+            return _Base.is_exhaustive();
+        }
+        _NODISCARD constexpr bool is_strided() const noexcept {
+            return _Base.is_strided();
+        }
+
+        _NODISCARD constexpr size_type stride(const size_t _Rank) const noexcept {
+            constexpr size_t _Dims[] = {_Perm..., 0};
+            return static_cast<size_type>(_Base.stride(_Dims[_Rank]));
+        }
+
+        template <class _OtherExtents>
+        _NODISCARD friend constexpr bool operator==(const mapping& _Lhs, const mapping<_OtherExtents>& _Rhs) noexcept {
+            return _Lhs.base_mapping() == _Rhs.base_mapping();
+        }
+
+    private:
+        _Extents _Myext{};
+        base_mapping_type _Base{};
+
+        template <size_t... _Seq>
+        constexpr size_type _Index_impl(
+            const array<index_type, _Extents::rank()>& _Idx, index_sequence<_Seq...>) const noexcept {
+            return static_cast<size_type>(_Base(_Idx[_Seq]...));
+        }
+    };
+
+    template <class _Seq, size_t _Rank, size_t... _Dims>
+    struct _Kept_dims_impl;
+
+    template <size_t... _Seq, size_t _Rank, size_t... _Dims>
+    struct _Kept_dims_impl<index_sequence<_Seq...>, _Rank, _Dims...> {
+        // The _Nth dimension below _Rank that is not one of _Dims.
+        static constexpr size_t _Kept(size_t _Nth) noexcept {
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                if (((_Dim != _Dims) && ...)) {
+                    if (_Nth == 0) {
+                        return _Dim;
+                    }
+                    --_Nth;
+                }
+            }
+            return _Rank;
+        }
+
+        using type = index_sequence<_Kept(_Seq)...>;
+    };
+
+    template <size_t _Rank, size_t... _Dims>
+    using _Kept_dims_t = typename _Kept_dims_impl<make_index_sequence<_Rank - sizeof...(_Dims)>, _Rank, _Dims...>::type;
+
+    // Repeats the data of a lower-rank _BaseLayout mapping along dimensions _Dims..., which have stride 0: a
+    // length-M bias vector can be used as an N x M array with layout_broadcast<layout_right, 0>. The other
+    // dimensions, in order, index the base mapping. Only the base mapping's elements are storage, so
+    // required_span_size() is the base's, and the mapping is not unique once a broadcast extent exceeds 1.
+    template <class _BaseLayout, size_t... _Dims>
+    struct layout_broadcast {
+        template <class _Extents> class mapping;
+    };
+
+    template <class _BaseLayout, size_t... _Dims>
+    template <class _Extents>
+    class layout_broadcast<_BaseLayout, _Dims...>::mapping {
+    public:
+        using extents_type = _Extents;
+        using index_type = typename _Extents::index_type;
+        using size_type = typename _Extents::size_type;
+        using rank_type = typename _Extents::rank_type;
+        using layout_type = layout_broadcast;
+
+        static_assert(((_Dims < _Extents::rank()) && ...), "Broadcast dimensions must be below the rank.");
+
+        using _Kept = _Kept_dims_t<_Extents::rank(), _Dims...>;
+        using base_mapping_type =
+            typename _BaseLayout::template mapping<typename _Pick_extents<_Extents, _Kept>::type>;
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const mapping&) noexcept = default;
+
+        constexpr mapping(const _Extents& _Ext)
+            : _Myext(_Ext), _Base(_Pick_extents<_Extents, _Kept>::_Apply(_Ext)) {}
+
+        constexpr mapping(const _Extents& _Ext, const base_mapping_type& _Base_) : _Myext(_Ext), _Base(_Base_) {
+            [[maybe_unused]] const auto _Kept_extents = _Pick_extents<_Extents, _Kept>::_Apply(_Ext);
+            _STL_VERIFY(_Base_.extents() == _Kept_extents,
+                "The base mapping's extents differ from the non-broadcast extents.");
+        }
+
+        constexpr mapping& operator=(const mapping&) noexcept = default;
+
+        _NODISCARD constexpr _Extents extents() const noexcept {
+            return _Myext;
+        }
+
+        _NODISCARD constexpr const base_mapping_type& base_mapping() const noexcept {
+            return _Base;
+        }
+
+        _NODISCARD static constexpr bool is_broadcast(const size_t _Dim) noexcept {
+            return ((_Dim == _Dims) || ...);
+        }
+
+        _NODISCARD constexpr size_type required_span_size() const noexcept {
+            return static_cast<size_type>(_Base.required_span_size());
+        }
+
+        template <class... _Indices,
+            enable_if_t<sizeof...(_Indices) == _Extents::rank() && (is_convertible_v<_Indices, index_type> && ...)
+            && (is_nothrow_constructible_v<index_type, _Indices> && ...),
+            int> = 0>
+        _NODISCARD constexpr size_type operator()(_Indices... _Idx) const noexcept {
+            return _Index_impl(array<index_type, _Extents::rank()>{static_cast<index_type>(_Idx)...}, _Kept{});
+        }
+
+        _NODISCARD static constexpr bool is_always_unique() noexcept {
+            return sizeof...(_Dims) == 0 && base_mapping_type::is_always_unique();
+        }
+        _NODISCARD static constexpr bool is_always_exhaustive() noexcept {
+            return base_mapping_type::is_always_exhaustive();
+        }
+        _NODISCARD static constexpr bool is_always_strided() noexcept {
+            return base_mapping_type::is_always_strided();
+        }
+
+        _NODISCARD constexpr bool is_unique() const noexcept {
+            return ((_Myext.extent(_Dims) <= 1) && ...) && _Base.is_unique();
+        }
+        _NODISCARD constexpr bool is_exhaustive() const noexcept {
+            return _Base.is_exhaustive();
+        }
+        _NODISCARD constexpr bool is_strided() const noexcept {
+            return _Base.is_strided();
+        }
+
+        _NODISCARD constexpr size_type stride(const size_t _Rank) const noexcept {
+            if (is_broadcast(_Rank)) {
+                return 0;
+            }
+            size_t _Base_dim = _Rank;
+            ((_Base_dim -= _Dims < _Rank ? 1 : 0), ...);
+            return static_cast<size_type>(_Base.stride(_Base_dim));
+        }
+
+        template <class _OtherExtents>
+        _NODISCARD friend constexpr bool operator==(const mapping& _Lhs, const mapping<_OtherExtents>& _Rhs) noexcept {
+            return _Lhs.extents() == _Rhs.extents() && _Lhs.base_mapping() == _Rhs.base_mapping();
+        }
+
+    private:
+        _Extents _Myext{};
+        base_mapping_type _Base{};
+
+        template <size_t... _Seq>
+        constexpr size_type _Index_impl(
+            const array<index_type, _Extents::rank()>& _Idx, index_sequence<_Seq...>) const noexcept {
+            return static_cast<size_type>(_Base(_Idx[_Seq]...));
+        }
+    };
+
     template <class _ElementType>
     struct default_accessor {
         using offset_policy = default_accessor;
@@ -612,6 +1070,66 @@ namespace std {
         }
     };
 
+    // Wraps _Accessor and checks each access against the number of elements in the storage. An mdspan with a
+    // checked_accessor also checks its indices against its extents, and on construction that the mapping's
+    // required_span_size() fits the storage. Offset views keep the size of the whole storage.
+    template <class _Accessor>
+    class checked_accessor {
+    public:
+        using offset_policy = checked_accessor<typename _Accessor::offset_policy>;
+        using element_type = typename _Accessor::element_type;
+        using reference = typename _Accessor::reference;
+        using pointer = typename _Accessor::pointer;
+        using base_accessor_type = _Accessor;
+
+        explicit constexpr checked_accessor(const size_t _Size_, const _Accessor& _Base_ = _Accessor{})
+            : _Base(_Base_), _Size(_Size_) {}
+
+        template <class _OtherAccessor, enable_if_t<is_constructible_v<_Accessor, const _OtherAccessor&>, int> = 0>
+        constexpr checked_accessor(const checked_accessor<_OtherAccessor>& _Other)
+            : _Base(_Other.base_accessor()), _Size(_Other.storage_size()) {}
+
+        _NODISCARD constexpr const _Accessor& base_accessor() const noexcept {
+            return _Base;
+        }
+
+        _NODISCARD constexpr size_t storage_size() const noexcept {
+            return _Size;
+        }
+
+        _NODISCARD constexpr typename offset_policy::pointer offset(pointer _Ptr, size_t _Idx) const {
+            _STL_VERIFY(_Idx <= _Size, "mdspan offset out of the checked storage.");
+            return _Base.offset(_Ptr, _Idx);
+        }
+
+        _NODISCARD constexpr reference access(pointer _Ptr, size_t _Idx) const {
+            _STL_VERIFY(_Idx < _Size, "mdspan access out of the checked storage.");
+            return _Base.access(_Ptr, _Idx);
+        }
+
+    private:
+        _Accessor _Base;
+        size_t _Size;
+    };
+
+    template <class _Accessor>
+    inline constexpr bool _Is_checked_accessor_v = false;
+
+    template <class _Accessor>
+    inline constexpr bool _Is_checked_accessor_v<checked_accessor<_Accessor>> = true;
+
+    // The accessor of a view whose data handle is _Acc.offset(p, _Idx). A checked_accessor goes on checking against
+    // the storage that remains past _Idx.
+    template <class _Accessor>
+    _NODISCARD constexpr typename _Accessor::offset_policy _Offset_accessor(const _Accessor& _Acc, const size_t _Idx) {
+        if constexpr (_Is_checked_accessor_v<_Accessor>) {
+            return typename _Accessor::offset_policy(
+                _Acc.storage_size() - _Idx, _Offset_accessor(_Acc.base_accessor(), _Idx));
+        } else {
+            return typename _Accessor::offset_policy(_Acc);
+        }
+    }
+
     template <class _ElementType, class _Extents, class _LayoutPolicy = layout_right,
         class _AccessorPolicy = default_accessor<_ElementType>>
         class mdspan {
@@ -674,11 +1192,34 @@ namespace std {
             constexpr mdspan(pointer _Ptr_, const mapping_type& _Map_) : _Ptr{ _Ptr_ }, _Map{ _Map_ } {}
 
             constexpr mdspan(pointer _Ptr_, const mapping_type& _Map_, const accessor_type& _Acc_)
-                : _Ptr{ _Ptr_ }, _Map{ _Map_ }, _Acc{ _Acc_ } {}
+                : _Ptr{ _Ptr_ }, _Map{ _Map_ }, _Acc{ _Acc_ } {
+                if constexpr (_Is_checked_accessor_v<accessor_type>) {
+                    _STL_VERIFY(static_cast<size_t>(_Map.required_span_size()) <= _Acc.storage_size(),
+                        "The mapping's required span size exceeds the checked storage.");
+                }
+            }
 
-            // template <class OtherElementType, class OtherExtents, class OtherLayoutPolicy, class OtherAccessorPolicy>
-            // explicit(see below) constexpr mdspan(
-            //    const mdspan<OtherElementType, OtherExtents, OtherLayoutPolicy, OtherAccessorPolicy>& other);
+            // Views the same elements through converted extents, mapping and accessor: a T view converts to a
+            // const T view, and a layout_right view with static extents to a layout_stride view with dextents,
+            // without copying. The conversion is explicit where the mapping's or accessor's is.
+            template <class _OtherElementType, class _OtherExtents, class _OtherLayoutPolicy,
+                class _OtherAccessorPolicy,
+                enable_if_t<
+                is_constructible_v<mapping_type,
+                const typename _OtherLayoutPolicy::template mapping<_OtherExtents>&>
+                && is_constructible_v<accessor_type, const _OtherAccessorPolicy&>,
+                int> = 0>
+            explicit(
+                !is_convertible_v<const typename _OtherLayoutPolicy::template mapping<_OtherExtents>&, mapping_type>
+                || !is_convertible_v<const _OtherAccessorPolicy&, accessor_type>)
+            constexpr mdspan(
+                const mdspan<_OtherElementType, _OtherExtents, _OtherLayoutPolicy, _OtherAccessorPolicy>& _Other)
+                : _Ptr{ _Other.data() }, _Map{ _Other.mapping() }, _Acc{ _Other.accessor() } {
+                static_assert(is_constructible_v<pointer, const typename _OtherAccessorPolicy::pointer&>,
+                    "The other mdspan's pointer must convert to this mdspan's pointer.");
+                static_assert(is_constructible_v<extents_type, _OtherExtents>,
+                    "The other mdspan's extents must convert to this mdspan's extents.");
+            }
 
             constexpr mdspan& operator=(const mdspan& rhs) = default;
             constexpr mdspan& operator=(mdspan&& rhs) = default;
@@ -688,6 +1229,9 @@ namespace std {
             template <class... _SizeTypes,
                 enable_if_t<(is_convertible_v<_SizeTypes, size_type> && ...) && sizeof...(_SizeTypes) == rank(), int> = 0>
             _NODISCARD constexpr reference operator()(_SizeTypes... _Indices) const {
+                if constexpr (_Checks_indices) {
+                    _Verify_indices({static_cast<size_type>(_Indices)...});
+                }
                 return _Acc.access(_Ptr, _Map(_Indices...));
             }
 
@@ -760,12 +1304,331 @@ namespace std {
             template <class _SizeType, size_t _Size, size_t... _Idx>
             _NODISCARD constexpr reference _Index_impl(
                 const array<_SizeType, _Size>& _Indices, index_sequence<_Idx...>) const {
+                if constexpr (_Checks_indices) {
+                    _Verify_indices({static_cast<size_type>(_Indices[_Idx])...});
+                }
                 return _Acc.access(_Ptr, _Map(_Indices[_Idx]...));
             }
 
+            static constexpr bool _Checks_indices =
+                _MDSPAN_BOUNDS_CHECK != 0 || _Is_checked_accessor_v<_AccessorPolicy>;
+
+            constexpr void _Verify_indices(const array<size_type, rank()>& _Indices) const {
+                for (size_t _Dim = 0; _Dim < rank(); ++_Dim) {
+                    _STL_VERIFY(_Indices[_Dim] < extent(_Dim), "mdspan index out of range.");
+                }
+            }
+
             pointer _Ptr{};
             mapping_type _Map;
             accessor_type _Acc;
     };
 
+    // _View over storage of _Storage_size elements, with every index and access checked.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD constexpr mdspan<_ElementType, _Extents, _LayoutPolicy, checked_accessor<_AccessorPolicy>>
+        bounds_checked(
+            const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Storage_size) {
+        return {_View.data(), _View.mapping(), checked_accessor<_AccessorPolicy>(_Storage_size, _View.accessor())};
+    }
+
+    template <size_t... _Perm, class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD constexpr auto permute(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View);
+
+    template <class _Layout>
+    struct _Permuted_layout_traits {
+        static constexpr bool _Is_permuted = false;
+    };
+
+    template <class _BaseLayout, size_t... _Perm>
+    struct _Permuted_layout_traits<layout_permuted<_BaseLayout, _Perm...>> {
+        static constexpr bool _Is_permuted = true;
+
+        static constexpr size_t _Base_dim(const size_t _Dim) noexcept {
+            constexpr size_t _Dims[] = {_Perm..., 0};
+            return _Dims[_Dim];
+        }
+
+        // Permuting a permuted view permutes its base view by the composition.
+        template <size_t... _Outer, class _Span>
+        _NODISCARD static constexpr auto _Permute_base(const _Span& _View) {
+            using _Base_mapping = typename _Span::mapping_type::base_mapping_type;
+            const mdspan<typename _Span::element_type, typename _Base_mapping::extents_type, _BaseLayout,
+                typename _Span::accessor_type>
+                _Base_view(_View.data(), _View.mapping().base_mapping(), _View.accessor());
+            return _STD permute<_Base_dim(_Outer)...>(_Base_view);
+        }
+    };
+
+    // A view of _View with dimension i taken from dimension _Perm[i], over the same data. Reversing the dimensions
+    // of layout_right gives layout_left and vice versa; other permutations give layout_permuted.
+    template <size_t... _Perm, class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD constexpr auto permute(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View) {
+        static_assert(sizeof...(_Perm) == _Extents::rank(), "permute requires one index per dimension.");
+        static_assert(_Is_permutation_v<_Perm...>, "permute requires a permutation of 0, ..., rank - 1.");
+        using _Picked = _Pick_extents<_Extents, index_sequence<_Perm...>>;
+        using _New_extents = typename _Picked::type;
+
+        if constexpr (_Is_identity_permutation_v<_Perm...>) {
+            return _View;
+        } else if constexpr (_Permuted_layout_traits<_LayoutPolicy>::_Is_permuted) {
+            return _Permuted_layout_traits<_LayoutPolicy>::template _Permute_base<_Perm...>(_View);
+        } else if constexpr (_Is_reversal_permutation_v<_Perm...> && is_same_v<_LayoutPolicy, layout_right>) {
+            return mdspan<_ElementType, _New_extents, layout_left, _AccessorPolicy>(
+                _View.data(), layout_left::mapping<_New_extents>(_Picked::_Apply(_View.extents())), _View.accessor());
+        } else if constexpr (_Is_reversal_permutation_v<_Perm...> && is_same_v<_LayoutPolicy, layout_left>) {
+            return mdspan<_ElementType, _New_extents, layout_right, _AccessorPolicy>(
+                _View.data(), layout_right::mapping<_New_extents>(_Picked::_Apply(_View.extents())), _View.accessor());
+        } else {
+            using _Layout = layout_permuted<_LayoutPolicy, _Perm...>;
+            using _Mapping = typename _Layout::template mapping<_New_extents>;
+            return mdspan<_ElementType, _New_extents, _Layout, _AccessorPolicy>(
+                _View.data(), _Mapping(_View.mapping()), _View.accessor());
+        }
+    }
+
+    // _View repeated along dimensions _Dims... of extents _Ext; _View's extents must equal the others, in order.
+    template <size_t... _Dims, class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy,
+        class _NewExtents>
+    _NODISCARD constexpr mdspan<_ElementType, _NewExtents, layout_broadcast<_LayoutPolicy, _Dims...>, _AccessorPolicy>
+        broadcast(
+            const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const _NewExtents& _Ext) {
+        static_assert(_NewExtents::rank() == _Extents::rank() + sizeof...(_Dims),
+            "broadcast adds one dimension per broadcast index.");
+        using _Mapping = typename layout_broadcast<_LayoutPolicy, _Dims...>::template mapping<_NewExtents>;
+        return {_View.data(), _Mapping(_Ext, typename _Mapping::base_mapping_type(_View.mapping())), _View.accessor()};
+    }
+
+    // Product of the extents of _Extents if they are all static, otherwise dynamic_extent.
+    template <class _Extents>
+    inline constexpr size_t extents_static_size_v = [] {
+        size_t _Result = 1;
+        for (size_t _Dim = 0; _Dim < _Extents::rank(); ++_Dim) {
+            if (_Extents::static_extent(_Dim) == dynamic_extent) {
+                return dynamic_extent;
+            }
+            _Result *= _Extents::static_extent(_Dim);
+        }
+        return _Result;
+    }();
+
+    // _View with extents _Ext over the same elements in the same order. The layout must be layout_left or
+    // layout_right, whose mappings are exhaustive and keep that order under any extents. Mismatched element
+    // counts are a compile-time error when both extents are static and a runtime check otherwise.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _NewExtents>
+    _NODISCARD constexpr mdspan<_ElementType, _NewExtents, _LayoutPolicy, _AccessorPolicy> reshape(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const _NewExtents& _Ext) {
+        static_assert(_Is_any_of_v<_LayoutPolicy, layout_left, layout_right>,
+            "reshape requires layout_left or layout_right; copy other layouts first.");
+        if constexpr (extents_static_size_v<_Extents> != dynamic_extent
+                      && extents_static_size_v<_NewExtents> != dynamic_extent) {
+            static_assert(extents_static_size_v<_Extents> == extents_static_size_v<_NewExtents>,
+                "reshape must preserve the number of elements.");
+        } else {
+            size_t _New_size = 1;
+            for (size_t _Dim = 0; _Dim < _NewExtents::rank(); ++_Dim) {
+                _New_size *= static_cast<size_t>(_Ext.extent(_Dim));
+            }
+            _STL_VERIFY(
+                _New_size == static_cast<size_t>(_View.size()), "reshape must preserve the number of elements.");
+        }
+        return {_View.data(), typename _LayoutPolicy::template mapping<_NewExtents>(_Ext), _View.accessor()};
+    }
+
+    // reshape to extents<index_type, _New...>, where at most one of _New may be dynamic_extent, to be inferred from
+    // the element count. If _View's extents are all static, the inferred extent is static too.
+    template <size_t... _New, class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD constexpr auto reshape(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View) {
+        using _Index = typename _Extents::index_type;
+        constexpr size_t _Inferred = ((_New == dynamic_extent ? 1 : 0) + ... + 0);
+        constexpr size_t _Known = ((_New == dynamic_extent ? 1 : _New) * ... * 1);
+        static_assert(_Inferred <= 1, "reshape can infer at most one extent.");
+        static_assert(_Inferred == 0 || _Known != 0, "reshape cannot infer an extent beside a zero extent.");
+
+        if constexpr (_Inferred == 0) {
+            return _STD reshape(_View, extents<_Index, _New...>{});
+        } else if constexpr (extents_static_size_v<_Extents> != dynamic_extent) {
+            static_assert(
+                extents_static_size_v<_Extents> % _Known == 0, "reshape must preserve the number of elements.");
+            constexpr size_t _Missing = extents_static_size_v<_Extents> / _Known;
+            return _STD reshape(_View, extents<_Index, (_New == dynamic_extent ? _Missing : _New)...>{});
+        } else {
+            const auto _Size = static_cast<size_t>(_View.size());
+            _STL_VERIFY(_Size % _Known == 0, "reshape must preserve the number of elements.");
+            return _STD reshape(
+                _View, extents<_Index, _New...>{array<_Index, 1>{static_cast<_Index>(_Size / _Known)}});
+        }
+    }
+
+    template <class... _Extents>
+    struct _Extents_cat;
+
+    template <class _IndexType, size_t... _Ext>
+    struct _Extents_cat<extents<_IndexType, _Ext...>> {
+        using type = extents<_IndexType, _Ext...>;
+    };
+
+    template <class _IndexType, size_t... _Ext, class _OtherIndexType, size_t... _OtherExt, class... _Rest>
+    struct _Extents_cat<extents<_IndexType, _Ext...>, extents<_OtherIndexType, _OtherExt...>, _Rest...>
+        : _Extents_cat<extents<common_type_t<_IndexType, _OtherIndexType>, _Ext..., _OtherExt...>, _Rest...> {};
+
+    // The dimensions of _Extents..., in order.
+    template <class... _Extents>
+    using extents_cat_t = typename _Extents_cat<_Extents...>::type;
+
+    template <class... _Extents>
+    _NODISCARD constexpr extents_cat_t<_Extents...> extents_cat(const _Extents&... _Ext) noexcept {
+        using _Result = extents_cat_t<_Extents...>;
+        array<typename _Result::index_type, _Result::rank()> _All{};
+        size_t _Next = 0;
+        const auto _Append = [&](const auto& _Part) {
+            for (size_t _Dim = 0; _Dim < _Part.rank(); ++_Dim) {
+                _All[_Next++] = static_cast<typename _Result::index_type>(_Part.extent(_Dim));
+            }
+        };
+        (_Append(_Ext), ...);
+        return _STD _Make_extents<_Result>(_All);
+    }
+
+    // _Extents without dimensions _Dims....
+    template <class _Extents, size_t... _Dims>
+    using extents_drop_t = typename _Pick_extents<_Extents, _Kept_dims_t<_Extents::rank(), _Dims...>>::type;
+
+    template <size_t... _Dims, class _Extents>
+    _NODISCARD constexpr extents_drop_t<_Extents, _Dims...> extents_drop(const _Extents& _Ext) noexcept {
+        static_assert(((_Dims < _Extents::rank()) && ...), "Dropped dimensions must be below the rank.");
+        return _Pick_extents<_Extents, _Kept_dims_t<_Extents::rank(), _Dims...>>::_Apply(_Ext);
+    }
+
+    template <class _Extents, size_t _Pos, size_t _New, class _Seq = make_index_sequence<_Extents::rank() + 1>>
+    struct _Extents_insert;
+
+    template <class _Extents, size_t _Pos, size_t _New, size_t... _Seq>
+    struct _Extents_insert<_Extents, _Pos, _New, index_sequence<_Seq...>> {
+        static_assert(_Pos <= _Extents::rank(), "An inserted dimension must be at most the rank.");
+
+        static constexpr size_t _Static(const size_t _Dim) noexcept {
+            return _Dim < _Pos ? _Extents::static_extent(_Dim)
+                 : _Dim == _Pos ? _New
+                                : _Extents::static_extent(_Dim - 1);
+        }
+
+        using type = extents<typename _Extents::index_type, _Static(_Seq)...>;
+        using index_type = typename _Extents::index_type;
+
+        _NODISCARD static constexpr type _Apply(const _Extents& _Src, const index_type _Value) noexcept {
+            return _STD _Make_extents<type>({static_cast<index_type>(
+                _Seq < _Pos ? _Src.extent(_Seq) : _Seq == _Pos ? _Value : _Src.extent(_Seq - 1))...});
+        }
+    };
+
+    // _Extents with a dimension of extent _New inserted before dimension _Pos.
+    template <class _Extents, size_t _Pos, size_t _New>
+    using extents_insert_t = typename _Extents_insert<_Extents, _Pos, _New>::type;
+
+    template <size_t _Pos, size_t _New, class _Extents>
+    _NODISCARD constexpr extents_insert_t<_Extents, _Pos, _New> extents_insert(const _Extents& _Ext) noexcept {
+        static_assert(_New != dynamic_extent, "Pass the value of an inserted dynamic extent.");
+        return _Extents_insert<_Extents, _Pos, _New>::_Apply(_Ext, static_cast<typename _Extents::index_type>(_New));
+    }
+
+    template <size_t _Pos, class _Extents>
+    _NODISCARD constexpr extents_insert_t<_Extents, _Pos, dynamic_extent> extents_insert(
+        const _Extents& _Ext, const typename _Extents::index_type _Value) noexcept {
+        return _Extents_insert<_Extents, _Pos, dynamic_extent>::_Apply(_Ext, _Value);
+    }
+
+    template <class _Lhs, class _Rhs,
+        class _Seq = make_index_sequence<(_STD max)(_Lhs::rank(), _Rhs::rank())>>
+    struct _Extents_broadcast;
+
+    template <class _Lhs, class _Rhs, size_t... _Seq>
+    struct _Extents_broadcast<_Lhs, _Rhs, index_sequence<_Seq...>> {
+        static constexpr size_t _Rank = sizeof...(_Seq);
+
+        // Static extent _Dim of _Extents aligned to the last of _Rank dimensions; missing leading extents are 1.
+        template <class _Extents>
+        static constexpr size_t _Aligned(const size_t _Dim) noexcept {
+            constexpr size_t _Missing = _Rank - _Extents::rank();
+            return _Dim < _Missing ? 1 : _Extents::static_extent(_Dim - _Missing);
+        }
+
+        static constexpr size_t _Static(const size_t _Dim) noexcept {
+            const size_t _Left  = _Aligned<_Lhs>(_Dim);
+            const size_t _Right = _Aligned<_Rhs>(_Dim);
+            if (_Left == 1) {
+                return _Right;
+            }
+            return _Right == 1 || _Left != dynamic_extent ? _Left : _Right;
+        }
+
+        static constexpr bool _Compatible(const size_t _Dim) noexcept {
+            const size_t _Left  = _Aligned<_Lhs>(_Dim);
+            const size_t _Right = _Aligned<_Rhs>(_Dim);
+            return _Left == _Right || _Left == 1 || _Right == 1 || _Left == dynamic_extent
+                || _Right == dynamic_extent;
+        }
+
+        static_assert((_Compatible(_Seq) && ...), "The static extents cannot be broadcast together.");
+
+        using type = extents<common_type_t<typename _Lhs::index_type, typename _Rhs::index_type>, _Static(_Seq)...>;
+
+        template <class _Extents>
+        static constexpr size_t _Aligned_extent(const _Extents& _Ext, const size_t _Dim) noexcept {
+            const size_t _Missing = _Rank - _Extents::rank();
+            return _Dim < _Missing ? 1 : static_cast<size_t>(_Ext.extent(_Dim - _Missing));
+        }
+    };
+
+    // The shape of an elementwise operation on _Lhs and _Rhs: both are aligned to their last dimension, and an
+    // extent of 1, or a missing leading one, stretches to the other. A static extent on either side keeps the
+    // result's extent static.
+    template <class _Lhs, class _Rhs>
+    using extents_broadcast_t = typename _Extents_broadcast<_Lhs, _Rhs>::type;
+
+    template <class _Lhs, class _Rhs>
+    _NODISCARD constexpr extents_broadcast_t<_Lhs, _Rhs> extents_broadcast(const _Lhs& _Left, const _Rhs& _Right) {
+        using _Impl   = _Extents_broadcast<_Lhs, _Rhs>;
+        using _Result = typename _Impl::type;
+        array<typename _Result::index_type, _Result::rank()> _All{};
+        for (size_t _Dim = 0; _Dim < _Result::rank(); ++_Dim) {
+            const size_t _Left_extent  = _Impl::_Aligned_extent(_Left, _Dim);
+            const size_t _Right_extent = _Impl::_Aligned_extent(_Right, _Dim);
+            _STL_VERIFY(_Left_extent == _Right_extent || _Left_extent == 1 || _Right_extent == 1,
+                "The extents cannot be broadcast together.");
+            _All[_Dim] = static_cast<typename _Result::index_type>(_Left_extent == 1 ? _Right_extent : _Left_extent);
+        }
+        return _STD _Make_extents<_Result>(_All);
+    }
+
+    template <class _Lhs, class _Rhs, class _Seq = make_index_sequence<_Lhs::rank()>>
+    struct _Extents_merge;
+
+    template <class _Lhs, class _Rhs, size_t... _Seq>
+    struct _Extents_merge<_Lhs, _Rhs, index_sequence<_Seq...>> {
+        static_assert(_Lhs::rank() == _Rhs::rank(), "Merged extents must have the same rank.");
+        static_assert(((_Lhs::static_extent(_Seq) == dynamic_extent || _Rhs::static_extent(_Seq) == dynamic_extent
+                           || _Lhs::static_extent(_Seq) == _Rhs::static_extent(_Seq))
+                          && ...),
+            "Merged extents have different static extents.");
+
+        using type = extents<common_type_t<typename _Lhs::index_type, typename _Rhs::index_type>,
+            (_Lhs::static_extent(_Seq) == dynamic_extent ? _Rhs::static_extent(_Seq) : _Lhs::static_extent(_Seq))...>;
+    };
+
+    // Two extents known to be equal, as one type that is static wherever either is: merging a dextents operand
+    // with a static one keeps the other's static extents for the indexing of both.
+    template <class _Lhs, class _Rhs>
+    using extents_merge_t = typename _Extents_merge<_Lhs, _Rhs>::type;
+
+    template <class _Lhs, class _Rhs>
+    _NODISCARD constexpr extents_merge_t<_Lhs, _Rhs> extents_merge(const _Lhs& _Left, const _Rhs& _Right) {
+        _STL_VERIFY(_Left == _Right, "Merged extents differ.");
+        using _Result = extents_merge_t<_Lhs, _Rhs>;
+        array<typename _Result::index_type, _Result::rank()> _All{};
+        for (size_t _Dim = 0; _Dim < _Result::rank(); ++_Dim) {
+            _All[_Dim] = static_cast<typename _Result::index_type>(_Left.extent(_Dim));
+        }
+        return _STD _Make_extents<_Result>(_All);
+    }
 } // namespace std
\ No newline at end of file
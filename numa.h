@@ -0,0 +1,229 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdarray.h"
+#include "thread_pool.h"
+#include <memory>
+#include <new>
+
+namespace std {
+    // How an array is split across NUMA nodes: node k owns indices [bounds[k], bounds[k + 1]) of dimension. The
+    // dimension is the one with the largest stride (the leftmost of layout_right, the rightmost of layout_left), so
+    // each node's share is one contiguous block of memory.
+    struct numa_partition {
+        size_t dimension = 0;
+        vector<size_t> bounds;
+
+        _NODISCARD size_t node_count() const noexcept {
+            return bounds.empty() ? 0 : bounds.size() - 1;
+        }
+    };
+
+    template <class _Mapping>
+    _NODISCARD numa_partition make_numa_partition(const _Mapping& _Map, const size_t _Nodes) {
+        static_assert(_Mapping::is_always_strided(), "NUMA partitioning requires a strided layout.");
+        static_assert(_Mapping::extents_type::rank() > 0, "NUMA partitioning requires a rank of at least 1.");
+        _STL_VERIFY(_Nodes > 0, "NUMA partitioning requires at least one node.");
+
+        numa_partition _Result;
+        for (size_t _Dim = 1; _Dim < _Mapping::extents_type::rank(); ++_Dim) {
+            if (_Map.stride(_Dim) > _Map.stride(_Result.dimension)) {
+                _Result.dimension = _Dim;
+            }
+        }
+
+        const size_t _Extent = _Map.extents().extent(_Result.dimension);
+        _Result.bounds.resize(_Nodes + 1);
+        for (size_t _Node = 0; _Node <= _Nodes; ++_Node) {
+            _Result.bounds[_Node] = _Extent * _Node / _Nodes;
+        }
+
+        return _Result;
+    }
+
+    // A fixed-size, page-aligned buffer whose elements [bounds[k], bounds[k + 1]) are first written by workers of
+    // NUMA node k. Under the usual first-touch policy, that places each node's share of the pages on that node.
+    template <class _Ty>
+    class numa_vector {
+    public:
+        static_assert(is_nothrow_default_constructible_v<_Ty> && is_trivially_destructible_v<_Ty>,
+            "numa_vector holds plain numeric data.");
+
+        using value_type = _Ty;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = _Ty*;
+        using const_pointer = const _Ty*;
+        using reference = _Ty&;
+        using const_reference = const _Ty&;
+        using iterator = _Ty*;
+        using const_iterator = const _Ty*;
+
+        static constexpr size_t _Page_size = 4096;
+
+        numa_vector(work_stealing_pool& _Pool, vector<size_t> _Element_bounds) : _Bounds(_STD move(_Element_bounds)) {
+            _STL_VERIFY(!_Bounds.empty() && _Bounds.front() == 0, "The first NUMA bound must be zero.");
+            _STL_VERIFY(_Bounds.size() - 1 <= _Pool.node_count(), "More NUMA parts than pool nodes.");
+
+            _Size = _Bounds.back();
+            if (_Size == 0) {
+                return;
+            }
+
+            // Declared before _Group, so on an exception the queued parts finish before they are destroyed.
+            _Allocation_guard _Guard{
+                static_cast<_Ty*>(::operator new(_Size * sizeof(_Ty), align_val_t{_Page_size})), {}};
+            _Guard._Parts.reserve(_Pool.size());
+
+            task_group _Group(_Pool);
+            for (size_t _Node = 0; _Node + 1 < _Bounds.size(); ++_Node) {
+                _STL_VERIFY(_Bounds[_Node] <= _Bounds[_Node + 1], "NUMA bounds must be nondecreasing.");
+
+                // Spread each node's first touch over all of its workers.
+                const size_t _Workers = _Pool.workers_on(_Node).size();
+                const size_t _Begin = _Bounds[_Node];
+                const size_t _Count = _Bounds[_Node + 1] - _Begin;
+                for (size_t _Part = 0; _Part < _Workers; ++_Part) {
+                    _Ty* const _First = _Guard._Ptr + _Begin + _Count * _Part / _Workers;
+                    _Ty* const _Last = _Guard._Ptr + _Begin + _Count * (_Part + 1) / _Workers;
+                    if (_First != _Last) {
+                        _Group.run_on_node(
+                            _Node, [_First, _Last] { _STD uninitialized_value_construct(_First, _Last); });
+                        _Guard._Parts.emplace_back(_First, _Last);
+                    }
+                }
+            }
+            _Group.wait();
+            _Data = _STD exchange(_Guard._Ptr, nullptr);
+        }
+
+        numa_vector(const numa_vector&) = delete;
+        numa_vector& operator=(const numa_vector&) = delete;
+
+        numa_vector(numa_vector&& _Other) noexcept
+            : _Data(_STD exchange(_Other._Data, nullptr)), _Size(_STD exchange(_Other._Size, 0)),
+              _Bounds(_STD move(_Other._Bounds)) {}
+
+        numa_vector& operator=(numa_vector&& _Other) noexcept {
+            if (this != &_Other) {
+                _Release();
+                _Data = _STD exchange(_Other._Data, nullptr);
+                _Size = _STD exchange(_Other._Size, 0);
+                _Bounds = _STD move(_Other._Bounds);
+            }
+            return *this;
+        }
+
+        ~numa_vector() {
+            _Release();
+        }
+
+        _NODISCARD pointer data() noexcept {
+            return _Data;
+        }
+        _NODISCARD const_pointer data() const noexcept {
+            return _Data;
+        }
+        _NODISCARD size_type size() const noexcept {
+            return _Size;
+        }
+        _NODISCARD reference operator[](const size_type _Idx) noexcept {
+            return _Data[_Idx];
+        }
+        _NODISCARD const_reference operator[](const size_type _Idx) const noexcept {
+            return _Data[_Idx];
+        }
+        _NODISCARD iterator begin() noexcept {
+            return _Data;
+        }
+        _NODISCARD const_iterator begin() const noexcept {
+            return _Data;
+        }
+        _NODISCARD iterator end() noexcept {
+            return _Data + _Size;
+        }
+        _NODISCARD const_iterator end() const noexcept {
+            return _Data + _Size;
+        }
+
+        // Element bounds of each node's share, as passed to the constructor.
+        _NODISCARD const vector<size_t>& element_bounds() const noexcept {
+            return _Bounds;
+        }
+
+    private:
+        // The buffer and its constructed parts while the constructor runs.
+        struct _Allocation_guard {
+            _Ty* _Ptr;
+            vector<pair<_Ty*, _Ty*>> _Parts;
+
+            ~_Allocation_guard() {
+                if (_Ptr) {
+                    for (const auto& _Part : _Parts) {
+                        _STD destroy(_Part.first, _Part.second);
+                    }
+                    ::operator delete(_Ptr, align_val_t{_Page_size});
+                }
+            }
+        };
+
+        void _Release() noexcept {
+            if (_Data) {
+                _STD destroy(_Data, _Data + _Size);
+                ::operator delete(_Data, align_val_t{_Page_size});
+                _Data = nullptr;
+            }
+        }
+
+        _Ty* _Data = nullptr;
+        size_t _Size = 0;
+        vector<size_t> _Bounds;
+    };
+
+    // Allocates an array partitioned over the nodes of _Pool by make_numa_partition, first touched by each node.
+    template <class _ElementType, class _LayoutPolicy = layout_right, class _Extents>
+    _NODISCARD mdarray<_ElementType, _Extents, _LayoutPolicy, numa_vector<_ElementType>> make_numa_mdarray(
+        work_stealing_pool& _Pool, const _Extents& _Ext) {
+        using _Mapping = typename _LayoutPolicy::template mapping<_Extents>;
+        static_assert(_Mapping::is_always_exhaustive() && _Mapping::is_always_strided(),
+            "NUMA arrays require an exhaustive, strided layout such as layout_right or layout_left.");
+
+        const _Mapping _Map{_Ext};
+        const auto _Partition = make_numa_partition(_Map, _Pool.node_count());
+        const size_t _Stride = _Map.stride(_Partition.dimension);
+        vector<size_t> _Elements(_Partition.bounds.size());
+        for (size_t _Node = 0; _Node < _Elements.size(); ++_Node) {
+            _Elements[_Node] = _Partition.bounds[_Node] * _Stride;
+        }
+        _Elements.back() = static_cast<size_t>(_Map.required_span_size());
+
+        return {_Map, numa_vector<_ElementType>(_Pool, _STD move(_Elements))};
+    }
+
+    // Like parallel_for_tiles, but the tiles within node k's share of _Partition.dimension run on the workers of
+    // node k, next to the memory that make_numa_mdarray placed there.
+    template <class _Extents, class _Fn>
+    void parallel_for_tiles(work_stealing_pool& _Pool, const _Extents& _Ext,
+        const array<size_t, _Extents::rank()>& _Grain, _Fn _Func, const numa_partition& _Partition) {
+        array<size_t, _Extents::rank()> _Lo{};
+        array<size_t, _Extents::rank()> _Hi{};
+        for (size_t _Dim = 0; _Dim < _Extents::rank(); ++_Dim) {
+            _Hi[_Dim] = _Ext.extent(_Dim);
+        }
+
+        task_group _Group(_Pool);
+        for (size_t _Node = 0; _Node < _Partition.node_count(); ++_Node) {
+            auto _Node_lo = _Lo;
+            auto _Node_hi = _Hi;
+            _Node_lo[_Partition.dimension] = _Partition.bounds[_Node];
+            _Node_hi[_Partition.dimension] = _Partition.bounds[_Node + 1];
+            const size_t _Run_on = _Node < _Pool.node_count() ? _Node : work_stealing_pool::any_node;
+            _Group.run_on_node(_Run_on, [&_Group, _Node_lo, _Node_hi, &_Grain, &_Func, _Run_on] {
+                _Parallel_for_box(_Group, _Node_lo, _Node_hi, _Grain, _Func, _Run_on);
+            });
+        }
+        _Group.wait();
+    }
+} // namespace std
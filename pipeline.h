@@ -0,0 +1,272 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace std {
+    // Fused traversals: pipeline(m) | mdpipe::map(f) | mdpipe::filter(p) | mdpipe::reduce(init, op). The stages are
+    // composed into one function applied to each element as a single walk of m's mapping reads it, with the
+    // smallest stride innermost. A pipeline built with a work_stealing_pool splits the outermost dimension across
+    // workers; reduce then combines per-block partials, so op must be associative and commutative as for
+    // std::reduce.
+
+    namespace mdpipe {
+        template <class _Fn>
+        struct _Map_stage {
+            _Fn _Func;
+
+            template <class _Ty, class _Next>
+            void _Apply(_Ty&& _Val, _Next& _Then) const {
+                _Then(_Func(_STD forward<_Ty>(_Val)));
+            }
+        };
+
+        template <class _Pr>
+        struct _Filter_stage {
+            _Pr _Pred;
+
+            template <class _Ty, class _Next>
+            void _Apply(_Ty&& _Val, _Next& _Then) const {
+                if (_Pred(_Val)) {
+                    _Then(_STD forward<_Ty>(_Val));
+                }
+            }
+        };
+
+        template <class _Ty, class _Op>
+        struct _Reduce_stage {
+            _Ty _Init;
+            _Op _Oper;
+        };
+
+        template <class _Fn>
+        struct _For_each_stage {
+            _Fn _Func;
+        };
+
+        template <class _Fn>
+        _NODISCARD constexpr _Map_stage<_Fn> map(_Fn _Func) {
+            return {_STD move(_Func)};
+        }
+
+        template <class _Pr>
+        _NODISCARD constexpr _Filter_stage<_Pr> filter(_Pr _Pred) {
+            return {_STD move(_Pred)};
+        }
+
+        template <class _Ty, class _Op = plus<>>
+        _NODISCARD constexpr _Reduce_stage<_Ty, _Op> reduce(_Ty _Init, _Op _Oper = {}) {
+            return {_STD move(_Init), _STD move(_Oper)};
+        }
+
+        template <class _Fn>
+        _NODISCARD constexpr _For_each_stage<_Fn> for_each(_Fn _Func) {
+            return {_STD move(_Func)};
+        }
+    } // namespace mdpipe
+
+    template <class _Span, class... _Stages>
+    class md_pipeline {
+    public:
+        md_pipeline(const _Span& _View_, work_stealing_pool* const _Pool_, const size_t _Grain_,
+            tuple<_Stages...> _Stages_ = {})
+            : _View(_View_), _Pool(_Pool_), _Grain(_Grain_), _Chain(_STD move(_Stages_)) {}
+
+        template <class _Stage>
+        _NODISCARD md_pipeline<_Span, _Stages..., _Stage> _Then(const _Stage& _Next) const {
+            return {_View, _Pool, _Grain, _STD tuple_cat(_Chain, _STD make_tuple(_Next))};
+        }
+
+        // Number of slices of the outermost dimension that _Run hands out.
+        _NODISCARD size_t _Block_count() const {
+            const size_t _Outer_extent = _View.extent(_Loop_order()[0]);
+            if (!_Pool) {
+                return 1;
+            }
+            const size_t _Grain_ = _Block_size(_Outer_extent);
+            return (_Outer_extent + _Grain_ - 1) / _Grain_;
+        }
+
+        // Calls _Sink_fn(block, value) for every value leaving the last stage, where block < _Block_count() numbers
+        // the slice of the outermost dimension being processed.
+        template <class _Sink>
+        void _Run(_Sink& _Sink_fn) const {
+            for (size_t _Dim = 0; _Dim < _Span::rank(); ++_Dim) {
+                if (_View.extent(_Dim) == 0) {
+                    return;
+                }
+            }
+
+            const auto _Order = _Loop_order();
+            const size_t _Outer_extent = _View.extent(_Order[0]);
+            if (!_Pool) {
+                _Walk(_Order, 0, _Outer_extent, 0, _Sink_fn);
+                return;
+            }
+
+            // Tile over whole blocks, so each block is walked by exactly one task: bisecting the outer extent
+            // itself would give tiles that straddle block boundaries.
+            const size_t _Grain_ = _Block_size(_Outer_extent);
+            parallel_for_tiles(*_Pool, dextents<size_t, 1>{_Block_count()}, array<size_t, 1>{1},
+                [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) {
+                    for (size_t _Block = _Lo[0]; _Block < _Hi[0]; ++_Block) {
+                        const size_t _First = _Block * _Grain_;
+                        _Walk(_Order, _First, (_STD min)(_First + _Grain_, _Outer_extent), _Block, _Sink_fn);
+                    }
+                });
+        }
+
+    private:
+        static_assert(_Span::rank() > 0, "Pipelines need a rank of at least 1.");
+
+        // Dimensions by decreasing stride: the outermost first, the contiguous one last.
+        _NODISCARD array<size_t, _Span::rank()> _Loop_order() const {
+            array<size_t, _Span::rank()> _Order{};
+            for (size_t _Dim = 0; _Dim < _Span::rank(); ++_Dim) {
+                _Order[_Dim] = _Dim;
+            }
+            if constexpr (_Span::is_always_strided()) {
+                const auto _Map = _View.mapping();
+                _STD stable_sort(_Order.begin(), _Order.end(), [&_Map](const size_t _Left, const size_t _Right) {
+                    return _Map.stride(_Left) > _Map.stride(_Right);
+                });
+            }
+            return _Order;
+        }
+
+        _NODISCARD size_t _Block_size(const size_t _Outer_extent) const {
+            if (_Grain != 0) {
+                return _Grain;
+            }
+            return (_STD max)(size_t{1}, _Outer_extent / (4 * _Pool->size()));
+        }
+
+        template <size_t _Stage, class _Ty, class _Sink>
+        void _Push(_Ty&& _Val, _Sink& _Sink_fn) const {
+            if constexpr (_Stage == sizeof...(_Stages)) {
+                _Sink_fn(_STD forward<_Ty>(_Val));
+            } else {
+                auto _Next = [this, &_Sink_fn](auto&& _Out) {
+                    _Push<_Stage + 1>(_STD forward<decltype(_Out)>(_Out), _Sink_fn);
+                };
+                _STD get<_Stage>(_Chain)._Apply(_STD forward<_Ty>(_Val), _Next);
+            }
+        }
+
+        template <size_t... _Seq>
+        _NODISCARD typename _Span::value_type _Read(
+            const array<size_t, _Span::rank()>& _Idx, index_sequence<_Seq...>) const {
+            return _View(_Idx[_Seq]...);
+        }
+
+        template <class _Sink>
+        void _Walk(const array<size_t, _Span::rank()>& _Order, const size_t _First, const size_t _Last,
+            const size_t _Block, _Sink& _Sink_fn) const {
+            constexpr size_t _Rank = _Span::rank();
+            const auto _Deliver = [&_Sink_fn, _Block](auto&& _Val) {
+                _Sink_fn(_Block, _STD forward<decltype(_Val)>(_Val));
+            };
+
+            array<size_t, _Rank> _Idx{};
+            _Idx[_Order[0]] = _First;
+            const size_t _Inner = _Order[_Rank - 1];
+            const size_t _Inner_extent = _Rank == 1 ? _Last : _View.extent(_Inner);
+            if (_First >= _Last) {
+                return;
+            }
+
+            for (;;) {
+                for (_Idx[_Inner] = _Rank == 1 ? _First : 0; _Idx[_Inner] < _Inner_extent; ++_Idx[_Inner]) {
+                    _Push<0>(_Read(_Idx, make_index_sequence<_Rank>{}), _Deliver);
+                }
+                if constexpr (_Rank == 1) {
+                    return;
+                } else {
+                    _Idx[_Inner] = 0;
+                    size_t _Level = _Rank - 1;
+                    for (; _Level > 0; --_Level) {
+                        const size_t _Dim = _Order[_Level - 1];
+                        const size_t _Limit = _Level == 1 ? _Last : _View.extent(_Dim);
+                        if (++_Idx[_Dim] < _Limit) {
+                            break;
+                        }
+                        _Idx[_Dim] = 0;
+                    }
+                    if (_Level == 0) {
+                        return;
+                    }
+                }
+            }
+        }
+
+        _Span _View;
+        work_stealing_pool* _Pool;
+        size_t _Grain;
+        tuple<_Stages...> _Chain;
+    };
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD md_pipeline<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>> pipeline(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View) {
+        return {_View, nullptr, 0};
+    }
+
+    // A pipeline whose outermost dimension is split into blocks of _Grain indices across _Pool; by default, about
+    // four blocks per worker.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    _NODISCARD md_pipeline<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>> pipeline(
+        work_stealing_pool& _Pool, const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View,
+        const size_t _Grain = 0) {
+        return {_View, &_Pool, _Grain};
+    }
+
+    template <class _Span, class... _Stages, class _Fn>
+    _NODISCARD md_pipeline<_Span, _Stages..., mdpipe::_Map_stage<_Fn>> operator|(
+        const md_pipeline<_Span, _Stages...>& _Pipe, const mdpipe::_Map_stage<_Fn>& _Stage) {
+        return _Pipe._Then(_Stage);
+    }
+
+    template <class _Span, class... _Stages, class _Pr>
+    _NODISCARD md_pipeline<_Span, _Stages..., mdpipe::_Filter_stage<_Pr>> operator|(
+        const md_pipeline<_Span, _Stages...>& _Pipe, const mdpipe::_Filter_stage<_Pr>& _Stage) {
+        return _Pipe._Then(_Stage);
+    }
+
+    template <class _Span, class... _Stages, class _Ty, class _Op>
+    _NODISCARD _Ty operator|(
+        const md_pipeline<_Span, _Stages...>& _Pipe, const mdpipe::_Reduce_stage<_Ty, _Op>& _Stage) {
+        // Each block folds into its own partial, empty until the block's first value.
+        vector<optional<_Ty>> _Partials(_Pipe._Block_count());
+
+        auto _Fold = [&_Partials, &_Stage](const size_t _Block, auto&& _Val) {
+            auto& _Partial = _Partials[_Block];
+            if (_Partial) {
+                _Partial = _Stage._Oper(_STD move(*_Partial), _STD forward<decltype(_Val)>(_Val));
+            } else {
+                _Partial.emplace(_STD forward<decltype(_Val)>(_Val));
+            }
+        };
+        _Pipe._Run(_Fold);
+
+        _Ty _Result = _Stage._Init;
+        for (auto& _Partial : _Partials) {
+            if (_Partial) {
+                _Result = _Stage._Oper(_STD move(_Result), _STD move(*_Partial));
+            }
+        }
+        return _Result;
+    }
+
+    template <class _Span, class... _Stages, class _Fn>
+    void operator|(const md_pipeline<_Span, _Stages...>& _Pipe, const mdpipe::_For_each_stage<_Fn>& _Stage) {
+        auto _Call = [&_Stage](size_t, auto&& _Val) { _Stage._Func(_STD forward<decltype(_Val)>(_Val)); };
+        _Pipe._Run(_Call);
+    }
+} // namespace std
@@ -0,0 +1,182 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "lines.h"
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace std {
+    // Sorting and selection along one axis of a strided mdspan. Every line along the axis is handled
+    // independently, by _Md_each_line, and the lines are split across a pool if one is given.
+
+    // Per-task state of the line kernels: the index permutation of argsort and top_k.
+    struct _Sort_scratch {
+        vector<size_t> _Order;
+
+        // The identity permutation of [0, _Length).
+        size_t* _Identity(const size_t _Length) {
+            _Order.resize(_Length);
+            _STD iota(_Order.begin(), _Order.end(), size_t{0});
+            return _Order.data();
+        }
+    };
+
+    // Calls _Func(line, data, scratch) for every line of _View along _Axis, as _Md_each_line does.
+    template <bool _Write_back, class _Span, class _Fn>
+    void _Sort_each_line(work_stealing_pool* const _Pool, const _Span& _View, const size_t _Axis, _Fn _Func) {
+        _Md_each_line<_Write_back>(_Pool, _View, _Axis, [] { return _Sort_scratch{}; }, _STD move(_Func));
+    }
+
+    // Orders indices by the values they select, breaking ties by index, so equal values keep their order.
+    template <class _Ty, class _Compare>
+    struct _Sort_index_less {
+        const _Ty* _Data;
+        _Compare& _Comp;
+
+        bool operator()(const size_t _Left, const size_t _Right) const {
+            if (_Comp(_Data[_Left], _Data[_Right])) {
+                return true;
+            }
+            return !_Comp(_Data[_Right], _Data[_Left]) && _Left < _Right;
+        }
+    };
+
+    // Writes _Count values of _Order, converted by _Get, along line _Line of _Out.
+    template <class _OutSpan, class _Mapping, class _Get>
+    void _Sort_store_line(const _OutSpan& _Out, const _Md_lines<_Mapping>& _Lines, const size_t _Line,
+        const size_t _Axis, const size_t* const _Order, const size_t _Count, _Get _Value_of) {
+        const auto _Map = _Out.mapping();
+        const auto _Acc = _Out.accessor();
+        const size_t _Base = _Lines._Base(_Map, _Line);
+        const size_t _Stride = _Map.stride(_Axis);
+        for (size_t _Pos = 0; _Pos < _Count; ++_Pos) {
+            _Acc.access(_Out.data(), _Base + _Pos * _Stride) =
+                static_cast<typename _OutSpan::value_type>(_Value_of(_Order[_Pos]));
+        }
+    }
+
+    template <class _Span, class _Compare>
+    void _Sort_along(work_stealing_pool* const _Pool, const _Span& _View, const size_t _Axis, _Compare _Comp) {
+        _STL_VERIFY(_Axis < _Span::rank(), "Sort axis out of range.");
+        const size_t _Length = _View.extent(_Axis);
+        _Sort_each_line<true>(_Pool, _View, _Axis,
+            [&](size_t, auto* const _Data, _Sort_scratch&) { _STD sort(_Data, _Data + _Length, _Comp); });
+    }
+
+    template <class _Span, class _Compare>
+    void _Nth_element_along(work_stealing_pool* const _Pool, const _Span& _View, const size_t _Axis,
+        const size_t _Nth, _Compare _Comp) {
+        _STL_VERIFY(_Axis < _Span::rank(), "Sort axis out of range.");
+        const size_t _Length = _View.extent(_Axis);
+        _STL_VERIFY(_Nth < _Length || _Length == 0, "nth_element_along position out of range.");
+        _Sort_each_line<true>(_Pool, _View, _Axis, [&](size_t, auto* const _Data, _Sort_scratch&) {
+            _STD nth_element(_Data, _Data + _Nth, _Data + _Length, _Comp);
+        });
+    }
+
+    template <class _InSpan, class _OutSpan, class _Compare>
+    void _Argsort(work_stealing_pool* const _Pool, const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis,
+        _Compare _Comp) {
+        static_assert(is_integral_v<typename _OutSpan::value_type>, "argsort writes integer indices.");
+        static_assert(_OutSpan::is_always_strided(), "argsort requires a strided output layout.");
+        _STL_VERIFY(_Axis < _InSpan::rank(), "Sort axis out of range.");
+        _STL_VERIFY(_In.extents() == _Out.extents(), "argsort input and output extents differ.");
+        const size_t _Length = _In.extent(_Axis);
+        const _Md_lines _Lines(_In.mapping(), _Axis);
+        _Sort_each_line<false>(_Pool, _In, _Axis, [&](const size_t _Line, auto* const _Data, _Sort_scratch& _Scratch) {
+            size_t* const _Order = _Scratch._Identity(_Length);
+            using _Ty = remove_cvref_t<decltype(*_Data)>;
+            _STD sort(_Order, _Order + _Length, _Sort_index_less<_Ty, _Compare>{_Data, _Comp});
+            _Sort_store_line(_Out, _Lines, _Line, _Axis, _Order, _Length, [](const size_t _Idx) { return _Idx; });
+        });
+    }
+
+    template <class _InSpan, class _ValueSpan, class _IndexSpan, class _Compare>
+    void _Top_k(work_stealing_pool* const _Pool, const _InSpan& _In, const _ValueSpan& _Values,
+        const _IndexSpan& _Indices, const size_t _Axis, _Compare _Comp) {
+        static_assert(is_integral_v<typename _IndexSpan::value_type>, "top_k writes integer indices.");
+        static_assert(_ValueSpan::is_always_strided() && _IndexSpan::is_always_strided(),
+            "top_k requires strided output layouts.");
+        _STL_VERIFY(_Axis < _InSpan::rank(), "Sort axis out of range.");
+        _STL_VERIFY(_Values.extents() == _Indices.extents(), "top_k value and index extents differ.");
+        const size_t _Length = _In.extent(_Axis);
+        const size_t _Count = _Values.extent(_Axis);
+        _STL_VERIFY(_Count <= _Length, "top_k cannot select more elements than a line has.");
+        for (size_t _Dim = 0; _Dim < _InSpan::rank(); ++_Dim) {
+            _STL_VERIFY(_Dim == _Axis || _Values.extent(_Dim) == _In.extent(_Dim),
+                "top_k outputs must match the input outside the axis.");
+        }
+
+        const _Md_lines _Lines(_In.mapping(), _Axis);
+        _Sort_each_line<false>(_Pool, _In, _Axis, [&](const size_t _Line, auto* const _Data, _Sort_scratch& _Scratch) {
+            size_t* const _Order = _Scratch._Identity(_Length);
+            using _Ty = remove_cvref_t<decltype(*_Data)>;
+            _STD partial_sort(_Order, _Order + _Count, _Order + _Length, _Sort_index_less<_Ty, _Compare>{_Data, _Comp});
+            _Sort_store_line(_Values, _Lines, _Line, _Axis, _Order, _Count, [_Data](const size_t _Idx) {
+                return _Data[_Idx];
+            });
+            _Sort_store_line(_Indices, _Lines, _Line, _Axis, _Order, _Count, [](const size_t _Idx) { return _Idx; });
+        });
+    }
+
+    // Sorts every line of _View along _Axis.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _Compare = less<>>
+    void sort_along(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Axis,
+        _Compare _Comp = {}) {
+        _Sort_along(nullptr, _View, _Axis, _Comp);
+    }
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _Compare = less<>>
+    void sort_along(work_stealing_pool& _Pool,
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Axis,
+        _Compare _Comp = {}) {
+        _Sort_along(&_Pool, _View, _Axis, _Comp);
+    }
+
+    // Partitions every line of _View along _Axis around position _Nth, as nth_element does.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _Compare = less<>>
+    void nth_element_along(const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View,
+        const size_t _Axis, const size_t _Nth, _Compare _Comp = {}) {
+        _Nth_element_along(nullptr, _View, _Axis, _Nth, _Comp);
+    }
+
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy, class _Compare = less<>>
+    void nth_element_along(work_stealing_pool& _Pool,
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>& _View, const size_t _Axis,
+        const size_t _Nth, _Compare _Comp = {}) {
+        _Nth_element_along(&_Pool, _View, _Axis, _Nth, _Comp);
+    }
+
+    // Writes to each line of _Out along _Axis the positions of the elements of the same line of _In in sorted
+    // order. Equal elements keep their order.
+    template <class _InSpan, class _OutSpan, class _Compare = less<>>
+    void argsort(const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis, _Compare _Comp = {}) {
+        _Argsort(nullptr, _In, _Out, _Axis, _Comp);
+    }
+
+    template <class _InSpan, class _OutSpan, class _Compare = less<>>
+    void argsort(
+        work_stealing_pool& _Pool, const _InSpan& _In, const _OutSpan& _Out, const size_t _Axis, _Compare _Comp = {}) {
+        _Argsort(&_Pool, _In, _Out, _Axis, _Comp);
+    }
+
+    // Writes the first _Values.extent(_Axis) elements of each line of _In along _Axis in _Comp order, largest first
+    // by default, to _Values, and their positions to _Indices. The outputs have _In's extents outside the axis.
+    template <class _InSpan, class _ValueSpan, class _IndexSpan, class _Compare = greater<>>
+    void top_k(const _InSpan& _In, const _ValueSpan& _Values, const _IndexSpan& _Indices, const size_t _Axis,
+        _Compare _Comp = {}) {
+        _Top_k(nullptr, _In, _Values, _Indices, _Axis, _Comp);
+    }
+
+    template <class _InSpan, class _ValueSpan, class _IndexSpan, class _Compare = greater<>>
+    void top_k(work_stealing_pool& _Pool, const _InSpan& _In, const _ValueSpan& _Values, const _IndexSpan& _Indices,
+        const size_t _Axis, _Compare _Comp = {}) {
+        _Top_k(&_Pool, _In, _Values, _Indices, _Axis, _Comp);
+    }
+} // namespace std
@@ -0,0 +1,335 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <span>
+
+namespace std {
+    // Non-owning sparse matrix views. The shape is an extents, and the stored values are exposed as a rank-1
+    // mdspan, so they can be handed to dense code (scaling, reductions, accessors) unchanged.
+
+    // Compressed sparse rows: the entries of row i are [row_offsets[i], row_offsets[i + 1]) of column_indices and
+    // values.
+    template <class _ElementType, class _IndexType = size_t>
+    class csr_matrix_view {
+    public:
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<_ElementType>;
+        using index_type = _IndexType;
+        using extents_type = dextents<_IndexType, 2>;
+        using values_type = mdspan<_ElementType, dextents<_IndexType, 1>>;
+
+        struct row_type {
+            span<const _IndexType> columns;
+            span<_ElementType> values;
+        };
+
+        constexpr csr_matrix_view() noexcept = default;
+
+        constexpr csr_matrix_view(const extents_type& _Ext_, span<const _IndexType> _Row_offsets_,
+            span<const _IndexType> _Columns_, span<_ElementType> _Values_) noexcept
+            : _Ext(_Ext_), _Row_offsets(_Row_offsets_), _Columns(_Columns_), _Values(_Values_) {
+            _STL_VERIFY(_Row_offsets.size() == static_cast<size_t>(_Ext.extent(0)) + 1,
+                "A CSR matrix needs one row offset per row plus one.");
+            _STL_VERIFY(_Columns.size() == _Values.size(), "A CSR matrix needs one column index per value.");
+            _STL_VERIFY(static_cast<size_t>(_Row_offsets.back()) == _Values.size(),
+                "The last CSR row offset must equal the number of values.");
+        }
+
+        _NODISCARD constexpr extents_type extents() const noexcept {
+            return _Ext;
+        }
+
+        _NODISCARD constexpr size_t extent(const size_t r) const noexcept {
+            return _Ext.extent(r);
+        }
+
+        _NODISCARD constexpr size_t nnz() const noexcept {
+            return _Values.size();
+        }
+
+        _NODISCARD constexpr span<const _IndexType> row_offsets() const noexcept {
+            return _Row_offsets;
+        }
+
+        _NODISCARD constexpr span<const _IndexType> column_indices() const noexcept {
+            return _Columns;
+        }
+
+        _NODISCARD constexpr values_type values() const noexcept {
+            return values_type{_Values.data(), static_cast<_IndexType>(_Values.size())};
+        }
+
+        _NODISCARD constexpr row_type row(const size_t _Row) const noexcept {
+            const auto _Begin = static_cast<size_t>(_Row_offsets[_Row]);
+            const auto _Count = static_cast<size_t>(_Row_offsets[_Row + 1]) - _Begin;
+            return {_Columns.subspan(_Begin, _Count), _Values.subspan(_Begin, _Count)};
+        }
+
+    private:
+        extents_type _Ext{};
+        span<const _IndexType> _Row_offsets;
+        span<const _IndexType> _Columns;
+        span<_ElementType> _Values;
+    };
+
+    // Coordinate list: entry k is values[k] at (row_indices[k], column_indices[k]), in any order.
+    template <class _ElementType, class _IndexType = size_t>
+    class coo_matrix_view {
+    public:
+        using element_type = _ElementType;
+        using value_type = remove_cv_t<_ElementType>;
+        using index_type = _IndexType;
+        using extents_type = dextents<_IndexType, 2>;
+        using values_type = mdspan<_ElementType, dextents<_IndexType, 1>>;
+
+        constexpr coo_matrix_view() noexcept = default;
+
+        constexpr coo_matrix_view(const extents_type& _Ext_, span<const _IndexType> _Rows_,
+            span<const _IndexType> _Columns_, span<_ElementType> _Values_) noexcept
+            : _Ext(_Ext_), _Rows(_Rows_), _Columns(_Columns_), _Values(_Values_) {
+            _STL_VERIFY(_Rows.size() == _Values.size() && _Columns.size() == _Values.size(),
+                "A COO matrix needs one row and one column index per value.");
+        }
+
+        _NODISCARD constexpr extents_type extents() const noexcept {
+            return _Ext;
+        }
+
+        _NODISCARD constexpr size_t extent(const size_t r) const noexcept {
+            return _Ext.extent(r);
+        }
+
+        _NODISCARD constexpr size_t nnz() const noexcept {
+            return _Values.size();
+        }
+
+        _NODISCARD constexpr span<const _IndexType> row_indices() const noexcept {
+            return _Rows;
+        }
+
+        _NODISCARD constexpr span<const _IndexType> column_indices() const noexcept {
+            return _Columns;
+        }
+
+        _NODISCARD constexpr values_type values() const noexcept {
+            return values_type{_Values.data(), static_cast<_IndexType>(_Values.size())};
+        }
+
+    private:
+        extents_type _Ext{};
+        span<const _IndexType> _Rows;
+        span<const _IndexType> _Columns;
+        span<_ElementType> _Values;
+    };
+
+    // Calls _Func(i, j, value) for every stored entry, where value is a reference to the stored element.
+    template <class _ElementType, class _IndexType, class _Fn>
+    void for_each_nonzero(const csr_matrix_view<_ElementType, _IndexType>& _Mat, _Fn _Func) {
+        const auto _Offsets = _Mat.row_offsets();
+        const auto _Columns = _Mat.column_indices();
+        const auto _Values = _Mat.values();
+        for (size_t _Row = 0; _Row < _Mat.extent(0); ++_Row) {
+            for (auto _Pos = static_cast<size_t>(_Offsets[_Row]); _Pos < static_cast<size_t>(_Offsets[_Row + 1]);
+                 ++_Pos) {
+                _Func(static_cast<_IndexType>(_Row), _Columns[_Pos], _Values(_Pos));
+            }
+        }
+    }
+
+    template <class _ElementType, class _IndexType, class _Fn>
+    void for_each_nonzero(const coo_matrix_view<_ElementType, _IndexType>& _Mat, _Fn _Func) {
+        const auto _Rows = _Mat.row_indices();
+        const auto _Columns = _Mat.column_indices();
+        const auto _Values = _Mat.values();
+        for (size_t _Pos = 0; _Pos < _Mat.nnz(); ++_Pos) {
+            _Func(_Rows[_Pos], _Columns[_Pos], _Values(_Pos));
+        }
+    }
+
+    // Sorts the entries of _Coo into CSR order (stable within a row) in the caller's buffers, which need
+    // extent(0) + 1 and nnz() elements, and returns a view of them.
+    template <class _ElementType, class _IndexType, class _OutElement>
+    csr_matrix_view<_OutElement, _IndexType> coo_to_csr(const coo_matrix_view<_ElementType, _IndexType>& _Coo,
+        span<_IndexType> _Row_offsets, span<_IndexType> _Columns, span<_OutElement> _Values) {
+        const size_t _Row_count = _Coo.extent(0);
+        _STL_VERIFY(_Row_offsets.size() == _Row_count + 1 && _Columns.size() == _Coo.nnz()
+                        && _Values.size() == _Coo.nnz(),
+            "coo_to_csr output buffers have the wrong sizes.");
+
+        const auto _Rows = _Coo.row_indices();
+        const auto _Coo_columns = _Coo.column_indices();
+        const auto _Coo_values = _Coo.values();
+
+        // Counting sort by row.
+        _STD fill(_Row_offsets.begin(), _Row_offsets.end(), _IndexType{0});
+        for (size_t _Pos = 0; _Pos < _Coo.nnz(); ++_Pos) {
+            const auto _Row = static_cast<size_t>(_Rows[_Pos]);
+            const bool _In_range = _Row < _Row_count && static_cast<size_t>(_Coo_columns[_Pos]) < _Coo.extent(1);
+            _STL_VERIFY(_In_range, "COO entry index out of range.");
+            ++_Row_offsets[_Row + 1];
+        }
+        for (size_t _Row = 0; _Row < _Row_count; ++_Row) {
+            _Row_offsets[_Row + 1] += _Row_offsets[_Row];
+        }
+
+        for (size_t _Pos = 0; _Pos < _Coo.nnz(); ++_Pos) {
+            // _Row_offsets[r] temporarily holds the next free slot of row r.
+            auto& _Slot = _Row_offsets[static_cast<size_t>(_Rows[_Pos])];
+            _Columns[static_cast<size_t>(_Slot)] = _Coo_columns[_Pos];
+            _Values[static_cast<size_t>(_Slot)] = _Coo_values(_Pos);
+            ++_Slot;
+        }
+
+        // Each slot now holds the end of its row; shift back to beginnings.
+        for (size_t _Row = _Row_count; _Row > 0; --_Row) {
+            _Row_offsets[_Row] = _Row_offsets[_Row - 1];
+        }
+        _Row_offsets[0] = 0;
+
+        return {_Coo.extents(), span<const _IndexType>{_Row_offsets}, span<const _IndexType>{_Columns}, _Values};
+    }
+
+    template <class _ElementType, class _IndexType, class _XSpan, class _YSpan>
+    void _Spmv_rows(const csr_matrix_view<_ElementType, _IndexType>& _Mat, const _XSpan& _X, const _YSpan& _Y,
+        const size_t _First, const size_t _Last) {
+        using _Sum_t = decltype(_STD declval<typename csr_matrix_view<_ElementType, _IndexType>::value_type>()
+                                * _STD declval<typename _XSpan::value_type>());
+        const auto _Offsets = _Mat.row_offsets();
+        const auto _Columns = _Mat.column_indices();
+        const auto _Values = _Mat.values();
+        for (size_t _Row = _First; _Row < _Last; ++_Row) {
+            _Sum_t _Sum{};
+            for (auto _Pos = static_cast<size_t>(_Offsets[_Row]); _Pos < static_cast<size_t>(_Offsets[_Row + 1]);
+                 ++_Pos) {
+                _Sum += _Values(_Pos) * _X(_Columns[_Pos]);
+            }
+            _Y(_Row) = static_cast<typename _YSpan::value_type>(_Sum);
+        }
+    }
+
+    // C(i, :) over rows [_First, _Last) of C = A * B. When B and C have unit stride along columns, each stored
+    // entry of A scales a contiguous row of B into a contiguous row of C. Otherwise each column of C is a set
+    // of sparse dot products down a contiguous column of B.
+    template <class _ElementType, class _IndexType, class _BSpan, class _CSpan>
+    void _Spmm_rows(const csr_matrix_view<_ElementType, _IndexType>& _Mat, const _BSpan& _B, const _CSpan& _C,
+        const size_t _First, const size_t _Last) {
+        using _Out_t = typename _CSpan::value_type;
+        using _Sum_t = decltype(_STD declval<typename csr_matrix_view<_ElementType, _IndexType>::value_type>()
+                                * _STD declval<typename _BSpan::value_type>());
+        const auto _Offsets = _Mat.row_offsets();
+        const auto _Columns = _Mat.column_indices();
+        const auto _Values = _Mat.values();
+        const size_t _Cols = _C.extent(1);
+
+        bool _Row_major = true;
+        if constexpr (_BSpan::is_always_strided() && _CSpan::is_always_strided()) {
+            _Row_major = (_B.extent(0) < 2 || _B.stride(1) <= _B.stride(0))
+                      && (_C.extent(0) < 2 || _C.stride(1) <= _C.stride(0));
+        }
+
+        if (_Row_major) {
+            for (size_t _Row = _First; _Row < _Last; ++_Row) {
+                for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                    _C(_Row, _Col) = _Out_t{};
+                }
+                for (auto _Pos = static_cast<size_t>(_Offsets[_Row]); _Pos < static_cast<size_t>(_Offsets[_Row + 1]);
+                     ++_Pos) {
+                    const auto _Scale = _Values(_Pos);
+                    const auto _Src = static_cast<size_t>(_Columns[_Pos]);
+                    for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                        _C(_Row, _Col) = static_cast<_Out_t>(_C(_Row, _Col) + _Scale * _B(_Src, _Col));
+                    }
+                }
+            }
+        }
+        else {
+            for (size_t _Col = 0; _Col < _Cols; ++_Col) {
+                for (size_t _Row = _First; _Row < _Last; ++_Row) {
+                    _Sum_t _Sum{};
+                    for (auto _Pos = static_cast<size_t>(_Offsets[_Row]);
+                         _Pos < static_cast<size_t>(_Offsets[_Row + 1]); ++_Pos) {
+                        _Sum += _Values(_Pos) * _B(static_cast<size_t>(_Columns[_Pos]), _Col);
+                    }
+                    _C(_Row, _Col) = static_cast<_Out_t>(_Sum);
+                }
+            }
+        }
+    }
+
+    template <class _Mat, class _XSpan, class _YSpan>
+    void _Verify_spmv(const _Mat& _A, const _XSpan& _X, const _YSpan& _Y) {
+        static_assert(_XSpan::rank() == 1 && _YSpan::rank() == 1, "spmv requires rank-1 operands.");
+        _STL_VERIFY(_X.extent(0) == _A.extent(1) && _Y.extent(0) == _A.extent(0), "spmv operand extents mismatch.");
+    }
+
+    template <class _Mat, class _BSpan, class _CSpan>
+    void _Verify_spmm(const _Mat& _A, const _BSpan& _B, const _CSpan& _C) {
+        static_assert(_BSpan::rank() == 2 && _CSpan::rank() == 2, "spmm requires rank-2 operands.");
+        _STL_VERIFY(_B.extent(0) == _A.extent(1) && _C.extent(0) == _A.extent(0) && _C.extent(1) == _B.extent(1),
+            "spmm operand extents mismatch.");
+    }
+
+    // y = A x
+    template <class _ElementType, class _IndexType, class _XSpan, class _YSpan>
+    void spmv(const csr_matrix_view<_ElementType, _IndexType>& _A, const _XSpan& _X, const _YSpan& _Y) {
+        _Verify_spmv(_A, _X, _Y);
+        _Spmv_rows(_A, _X, _Y, 0, _A.extent(0));
+    }
+
+    // y = A x, with blocks of rows distributed over _Pool.
+    template <class _ElementType, class _IndexType, class _XSpan, class _YSpan>
+    void spmv(work_stealing_pool& _Pool, const csr_matrix_view<_ElementType, _IndexType>& _A, const _XSpan& _X,
+        const _YSpan& _Y, const size_t _Grain = 1024) {
+        _Verify_spmv(_A, _X, _Y);
+        parallel_for_tiles(_Pool, dextents<size_t, 1>{_A.extent(0)}, array<size_t, 1>{_Grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) { _Spmv_rows(_A, _X, _Y, _Lo[0], _Hi[0]); });
+    }
+
+    template <class _ElementType, class _IndexType, class _XSpan, class _YSpan>
+    void spmv(const coo_matrix_view<_ElementType, _IndexType>& _A, const _XSpan& _X, const _YSpan& _Y) {
+        _Verify_spmv(_A, _X, _Y);
+        using _Out_t = typename _YSpan::value_type;
+        for (size_t _Row = 0; _Row < _Y.extent(0); ++_Row) {
+            _Y(_Row) = _Out_t{};
+        }
+        for_each_nonzero(_A, [&](const _IndexType _Row, const _IndexType _Col, const auto& _Val) {
+            _Y(_Row) = static_cast<_Out_t>(_Y(_Row) + _Val * _X(_Col));
+        });
+    }
+
+    // C = A B
+    template <class _ElementType, class _IndexType, class _BSpan, class _CSpan>
+    void spmm(const csr_matrix_view<_ElementType, _IndexType>& _A, const _BSpan& _B, const _CSpan& _C) {
+        _Verify_spmm(_A, _B, _C);
+        _Spmm_rows(_A, _B, _C, 0, _A.extent(0));
+    }
+
+    // C = A B, with blocks of rows distributed over _Pool.
+    template <class _ElementType, class _IndexType, class _BSpan, class _CSpan>
+    void spmm(work_stealing_pool& _Pool, const csr_matrix_view<_ElementType, _IndexType>& _A, const _BSpan& _B,
+        const _CSpan& _C, const size_t _Grain = 64) {
+        _Verify_spmm(_A, _B, _C);
+        parallel_for_tiles(_Pool, dextents<size_t, 1>{_A.extent(0)}, array<size_t, 1>{_Grain},
+            [&](const array<size_t, 1>& _Lo, const array<size_t, 1>& _Hi) { _Spmm_rows(_A, _B, _C, _Lo[0], _Hi[0]); });
+    }
+
+    template <class _ElementType, class _IndexType, class _BSpan, class _CSpan>
+    void spmm(const coo_matrix_view<_ElementType, _IndexType>& _A, const _BSpan& _B, const _CSpan& _C) {
+        _Verify_spmm(_A, _B, _C);
+        using _Out_t = typename _CSpan::value_type;
+        for (size_t _Row = 0; _Row < _C.extent(0); ++_Row) {
+            for (size_t _Col = 0; _Col < _C.extent(1); ++_Col) {
+                _C(_Row, _Col) = _Out_t{};
+            }
+        }
+        for_each_nonzero(_A, [&](const _IndexType _Row, const _IndexType _Src, const auto& _Val) {
+            for (size_t _Col = 0; _Col < _C.extent(1); ++_Col) {
+                _C(_Row, _Col) = static_cast<_Out_t>(_C(_Row, _Col) + _Val * _B(_Src, _Col));
+            }
+        });
+    }
+} // namespace std
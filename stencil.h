@@ -0,0 +1,466 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include "thread_pool.h"
+#include <vector>
+
+namespace std {
+    // Stencil shapes. offsets lists the displacement of every point from the center, center first, and
+    // radius() is the width of the halo that the shape reads beyond the updated region.
+    template <size_t _Rank, size_t _Radius>
+    struct stencil_star {
+        static_assert(_Rank > 0 && _Radius > 0);
+
+        static constexpr size_t _Points = 2 * _Rank * _Radius + 1;
+
+        _NODISCARD static constexpr size_t rank() noexcept {
+            return _Rank;
+        }
+        _NODISCARD static constexpr size_t radius() noexcept {
+            return _Radius;
+        }
+        _NODISCARD static constexpr size_t size() noexcept {
+            return _Points;
+        }
+
+        static constexpr array<array<ptrdiff_t, _Rank>, _Points> offsets = []() constexpr {
+            array<array<ptrdiff_t, _Rank>, _Points> _Result{};
+            size_t _Point = 1;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                for (size_t _Dist = 1; _Dist <= _Radius; ++_Dist) {
+                    _Result[_Point++][_Dim] = -static_cast<ptrdiff_t>(_Dist);
+                    _Result[_Point++][_Dim] = static_cast<ptrdiff_t>(_Dist);
+                }
+            }
+            return _Result;
+        }();
+    };
+
+    template <size_t _Rank, size_t _Radius>
+    struct stencil_box {
+        static_assert(_Rank > 0 && _Radius > 0);
+
+        static constexpr size_t _Points = []() constexpr {
+            size_t _Result = 1;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _Result *= 2 * _Radius + 1;
+            }
+            return _Result;
+        }();
+
+        _NODISCARD static constexpr size_t rank() noexcept {
+            return _Rank;
+        }
+        _NODISCARD static constexpr size_t radius() noexcept {
+            return _Radius;
+        }
+        _NODISCARD static constexpr size_t size() noexcept {
+            return _Points;
+        }
+
+        static constexpr array<array<ptrdiff_t, _Rank>, _Points> offsets = []() constexpr {
+            array<array<ptrdiff_t, _Rank>, _Points> _Result{};
+            // The base-(2r + 1) digits 0, 1, ..., 2r of a point number map to offsets 0, 1, ..., r, -r, ..., -1,
+            // which makes point 0 the center.
+            for (size_t _Point = 0; _Point < _Points; ++_Point) {
+                size_t _Rest = _Point;
+                for (size_t _Dim = _Rank; _Dim-- > 0;) {
+                    const auto _Digit = static_cast<ptrdiff_t>(_Rest % (2 * _Radius + 1));
+                    _Result[_Point][_Dim] = _Digit <= static_cast<ptrdiff_t>(_Radius)
+                        ? _Digit : _Digit - static_cast<ptrdiff_t>(2 * _Radius + 1);
+                    _Rest /= 2 * _Radius + 1;
+                }
+            }
+            return _Result;
+        }();
+    };
+
+    struct stencil_blocking {
+        size_t inner_tile = 1024; // points per tile along the smallest-stride dimension
+        size_t outer_tile = 16; // points per tile along every other dimension
+        size_t time_steps = 4; // sweeps fused into one pass over memory by stencil_iterate
+    };
+
+    // Dimensions ordered from largest to smallest stride, so the innermost loop walks memory contiguously.
+    template <class _Mapping>
+    _NODISCARD constexpr array<size_t, _Mapping::extents_type::rank()> _Stencil_loop_order(
+        const _Mapping& _Map) noexcept {
+        constexpr size_t _Rank = _Mapping::extents_type::rank();
+        array<size_t, _Rank> _Order{};
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            _Order[_Dim] = _Dim;
+        }
+
+        if constexpr (_Mapping::is_always_strided()) {
+            for (size_t _Pos = 1; _Pos < _Rank; ++_Pos) {
+                const size_t _Dim = _Order[_Pos];
+                size_t _Hole = _Pos;
+                for (; _Hole > 0 && _Map.stride(_Order[_Hole - 1]) < _Map.stride(_Dim); --_Hole) {
+                    _Order[_Hole] = _Order[_Hole - 1];
+                }
+                _Order[_Hole] = _Dim;
+            }
+        }
+
+        return _Order;
+    }
+
+    template <class _Mapping, size_t _Rank, size_t... _Seq>
+    _NODISCARD constexpr size_t _Stencil_map(
+        const _Mapping& _Map, const array<size_t, _Rank>& _Idx, index_sequence<_Seq...>) noexcept {
+        return _Map(_Idx[_Seq]...);
+    }
+
+    // Calls _Func for every index in [_Lo, _Hi) in _Order, or, if _Lines, once per line along the last
+    // dimension in _Order with that coordinate set to _Lo.
+    template <bool _Lines, size_t _Level = 0, size_t _Rank, class _Fn>
+    void _Stencil_for_each(const array<size_t, _Rank>& _Order, const array<size_t, _Rank>& _Lo,
+        const array<size_t, _Rank>& _Hi, array<size_t, _Rank>& _Idx, _Fn& _Func) {
+        const size_t _Dim = _Order[_Level];
+        if constexpr (_Lines && _Level + 1 == _Rank) {
+            _Idx[_Dim] = _Lo[_Dim];
+            _Func(_STD as_const(_Idx));
+        }
+        else {
+            for (_Idx[_Dim] = _Lo[_Dim]; _Idx[_Dim] < _Hi[_Dim]; ++_Idx[_Dim]) {
+                if constexpr (_Level + 1 == _Rank) {
+                    _Func(_STD as_const(_Idx));
+                }
+                else {
+                    _Stencil_for_each<_Lines, _Level + 1>(_Order, _Lo, _Hi, _Idx, _Func);
+                }
+            }
+        }
+    }
+
+    // Applies the stencil once to every point of [_Lo, _Hi), which must lie at least radius() inside _In.
+    template <class _Shape, class _InSpan, class _OutSpan, class _Weight>
+    void _Stencil_sweep(const _InSpan& _In, const _OutSpan& _Out, const array<_Weight, _Shape::size()>& _Weights,
+        const array<size_t, _Shape::rank()>& _Lo, const array<size_t, _Shape::rank()>& _Hi) {
+        constexpr size_t _Rank = _Shape::rank();
+        using _Sum_t = decltype(_STD declval<const _Weight&>() * _STD declval<typename _InSpan::value_type>());
+        using _Out_t = typename _OutSpan::value_type;
+
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            if (_Lo[_Dim] >= _Hi[_Dim]) {
+                return;
+            }
+        }
+
+        const auto _Order = _Stencil_loop_order(_In.mapping());
+        const size_t _Inner = _Order[_Rank - 1];
+        const auto _In_map = _In.mapping();
+        const auto _Out_map = _Out.mapping();
+        const auto _In_acc = _In.accessor();
+        const auto _Out_acc = _Out.accessor();
+        array<size_t, _Rank> _Idx{};
+
+        if constexpr (_InSpan::is_always_strided() && _OutSpan::is_always_strided()) {
+            // Every stencil point is a fixed linear displacement from the center.
+            array<size_t, _Shape::size()> _Delta{};
+            for (size_t _Point = 0; _Point < _Shape::size(); ++_Point) {
+                for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                    _Delta[_Point] += static_cast<size_t>(_Shape::offsets[_Point][_Dim]) * _In_map.stride(_Dim);
+                }
+            }
+
+            const size_t _In_step = _In_map.stride(_Inner);
+            const size_t _Out_step = _Out_map.stride(_Inner);
+            const size_t _Count = _Hi[_Inner] - _Lo[_Inner];
+            auto _Line = [&](const array<size_t, _Rank>& _Start) {
+                size_t _In_pos = _Stencil_map(_In_map, _Start, make_index_sequence<_Rank>{});
+                size_t _Out_pos = _Stencil_map(_Out_map, _Start, make_index_sequence<_Rank>{});
+                for (size_t _Num = 0; _Num < _Count; ++_Num) {
+                    _Sum_t _Sum{};
+                    for (size_t _Point = 0; _Point < _Shape::size(); ++_Point) {
+                        _Sum += _Weights[_Point] * _In_acc.access(_In.data(), _In_pos + _Delta[_Point]);
+                    }
+                    _Out_acc.access(_Out.data(), _Out_pos) = static_cast<_Out_t>(_Sum);
+                    _In_pos += _In_step;
+                    _Out_pos += _Out_step;
+                }
+            };
+            _Stencil_for_each<true>(_Order, _Lo, _Hi, _Idx, _Line);
+        }
+        else {
+            auto _Elem = [&](const array<size_t, _Rank>& _Center) {
+                _Sum_t _Sum{};
+                for (size_t _Point = 0; _Point < _Shape::size(); ++_Point) {
+                    array<size_t, _Rank> _Shifted = _Center;
+                    for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                        _Shifted[_Dim] += static_cast<size_t>(_Shape::offsets[_Point][_Dim]);
+                    }
+                    _Sum += _Weights[_Point] * _In[_Shifted];
+                }
+                _Out[_Center] = static_cast<_Out_t>(_Sum);
+            };
+            _Stencil_for_each<false>(_Order, _Lo, _Hi, _Idx, _Elem);
+        }
+    }
+
+    // Calls _Func(_Lo, _Hi) for each tile of the interior of _Map's extents: in memory order if _Pool is null,
+    // otherwise as recursively split tasks on _Pool.
+    template <class _Shape, class _Mapping, class _Fn>
+    void _Stencil_for_each_tile(
+        work_stealing_pool* const _Pool, const _Mapping& _Map, const stencil_blocking& _Blocking, _Fn _Func) {
+        constexpr size_t _Rank = _Shape::rank();
+        constexpr size_t _Radius = _Shape::radius();
+        const auto _Ext = _Map.extents();
+        const auto _Order = _Stencil_loop_order(_Map);
+
+        array<size_t, _Rank> _Tile{};
+        array<size_t, _Rank> _Tiles_lo{};
+        array<size_t, _Rank> _Tiles_hi{};
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            if (_Ext.extent(_Dim) <= 2 * _Radius) {
+                return;
+            }
+
+            _Tile[_Dim] = (_STD max)(size_t{1}, _Dim == _Order[_Rank - 1] ? _Blocking.inner_tile : _Blocking.outer_tile);
+            _Tiles_hi[_Dim] = (_Ext.extent(_Dim) - 2 * _Radius + _Tile[_Dim] - 1) / _Tile[_Dim];
+        }
+
+        if (_Pool) {
+            array<size_t, _Rank> _Lo;
+            array<size_t, _Rank> _Hi;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _Lo[_Dim] = _Radius;
+                _Hi[_Dim] = _Ext.extent(_Dim) - _Radius;
+            }
+
+            task_group _Group(*_Pool);
+            _Parallel_for_box(_Group, _Lo, _Hi, _Tile, _Func);
+            _Group.wait();
+            return;
+        }
+
+        array<size_t, _Rank> _Tile_idx{};
+        auto _Visit = [&](const array<size_t, _Rank>& _Which) {
+            array<size_t, _Rank> _Lo;
+            array<size_t, _Rank> _Hi;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _Lo[_Dim] = _Radius + _Which[_Dim] * _Tile[_Dim];
+                _Hi[_Dim] = (_STD min)(_Lo[_Dim] + _Tile[_Dim], _Ext.extent(_Dim) - _Radius);
+            }
+            _Func(_Lo, _Hi);
+        };
+        _Stencil_for_each<false>(_Order, _Tiles_lo, _Tiles_hi, _Tile_idx, _Visit);
+    }
+
+    // Copies the halo of width radius() from _Src to _Dst.
+    template <class _Shape, class _SrcSpan, class _DstSpan>
+    void _Stencil_copy_halo(const _SrcSpan& _Src, const _DstSpan& _Dst) {
+        constexpr size_t _Rank = _Shape::rank();
+        constexpr size_t _Radius = _Shape::radius();
+        const auto _Order = _Stencil_loop_order(_Src.mapping());
+        const size_t _Inner = _Order[_Rank - 1];
+        const size_t _Size = _Src.extent(_Inner);
+
+        array<size_t, _Rank> _Lo{};
+        array<size_t, _Rank> _Hi{};
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            _Hi[_Dim] = _Src.extent(_Dim);
+        }
+
+        array<size_t, _Rank> _Idx{};
+        auto _Line = [&](const array<size_t, _Rank>& _Start) {
+            bool _Interior = true;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                if (_Dim != _Inner && (_Start[_Dim] < _Radius || _Start[_Dim] + _Radius >= _Src.extent(_Dim))) {
+                    _Interior = false;
+                }
+            }
+
+            array<size_t, _Rank> _Pos = _Start;
+            for (size_t _Num = 0; _Num < _Size; ++_Num) {
+                if (!_Interior || _Num < _Radius || _Num + _Radius >= _Size) {
+                    _Pos[_Inner] = _Num;
+                    _Dst[_Pos] = _Src[_Pos];
+                }
+            }
+        };
+        _Stencil_for_each<true>(_Order, _Lo, _Hi, _Idx, _Line);
+    }
+
+    template <class _SrcSpan, class _DstSpan, size_t _Rank>
+    void _Stencil_copy_box(const _SrcSpan& _Src, const array<size_t, _Rank>& _Src_origin, const _DstSpan& _Dst,
+        const array<size_t, _Rank>& _Dst_origin, const array<size_t, _Rank>& _Size) {
+        const auto _Order = _Stencil_loop_order(_Dst.mapping());
+        array<size_t, _Rank> _Lo{};
+        array<size_t, _Rank> _Idx{};
+        auto _Elem = [&](const array<size_t, _Rank>& _Offset) {
+            array<size_t, _Rank> _Src_idx;
+            array<size_t, _Rank> _Dst_idx;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _Src_idx[_Dim] = _Src_origin[_Dim] + _Offset[_Dim];
+                _Dst_idx[_Dim] = _Dst_origin[_Dim] + _Offset[_Dim];
+            }
+            _Dst[_Dst_idx] = _Src[_Src_idx];
+        };
+        _Stencil_for_each<false>(_Order, _Lo, _Size, _Idx, _Elem);
+    }
+
+    // Advances _Src by _Steps sweeps into _Dst, tile by tile. Each tile is loaded into a scratch block together
+    // with a halo of _Steps * radius() points, so all of the sweeps run while the block is in cache; the halo
+    // points are computed redundantly by neighboring tiles instead of being exchanged between sweeps.
+    template <class _Shape, class _SrcSpan, class _DstSpan, class _Weight>
+    void _Stencil_fused_pass(work_stealing_pool* const _Pool, const _SrcSpan& _Src, const _DstSpan& _Dst,
+        const array<_Weight, _Shape::size()>& _Weights, const size_t _Steps, const stencil_blocking& _Blocking) {
+        constexpr size_t _Rank = _Shape::rank();
+        constexpr size_t _Radius = _Shape::radius();
+        using _Value = typename _SrcSpan::value_type;
+        using _Block = mdspan<_Value, dextents<size_t, _Rank>, layout_stride>;
+
+        const auto _Order = _Stencil_loop_order(_Src.mapping());
+        vector<_Value> _Serial_a;
+        vector<_Value> _Serial_b;
+
+        _Stencil_for_each_tile<_Shape>(_Pool, _Src.mapping(), _Blocking,
+            [&](const array<size_t, _Rank>& _Lo, const array<size_t, _Rank>& _Hi) {
+                // Concurrent tiles need their own blocks; a serial pass reuses one pair.
+                vector<_Value> _Task_a;
+                vector<_Value> _Task_b;
+                auto& _Buf_a = _Pool ? _Task_a : _Serial_a;
+                auto& _Buf_b = _Pool ? _Task_b : _Serial_b;
+
+                // The block covers the tile plus the region it depends on, clipped to the grid.
+                array<size_t, _Rank> _Origin;
+                array<size_t, _Rank> _Size;
+                for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                    const size_t _Reach = _Steps * _Radius;
+                    _Origin[_Dim] = _Lo[_Dim] > _Reach ? _Lo[_Dim] - _Reach : 0;
+                    _Size[_Dim] = (_STD min)(_Hi[_Dim] + _Reach, _Src.extent(_Dim)) - _Origin[_Dim];
+                }
+
+                // Lay out the block in the same dimension order as the grid.
+                array<size_t, _Rank> _Strides;
+                size_t _Total = 1;
+                for (size_t _Level = _Rank; _Level-- > 0;) {
+                    _Strides[_Order[_Level]] = _Total;
+                    _Total *= _Size[_Order[_Level]];
+                }
+
+                _Buf_a.resize(_Total);
+                _Buf_b.resize(_Total);
+                const layout_stride::mapping<dextents<size_t, _Rank>> _Map{dextents<size_t, _Rank>{_Size}, _Strides};
+                _Block _Cur{_Buf_a.data(), _Map};
+                _Block _Next{_Buf_b.data(), _Map};
+
+                // Both buffers need the grid's halo, because the sweeps never write it.
+                const array<size_t, _Rank> _Zero{};
+                _Stencil_copy_box(_Src, _Origin, _Cur, _Zero, _Size);
+                _Stencil_copy_box(_Src, _Origin, _Next, _Zero, _Size);
+
+                for (size_t _Step = 1; _Step <= _Steps; ++_Step) {
+                    // After this sweep, only points within (_Steps - _Step) * radius() of the tile are needed.
+                    const size_t _Reach = (_Steps - _Step) * _Radius;
+                    array<size_t, _Rank> _Sweep_lo;
+                    array<size_t, _Rank> _Sweep_hi;
+                    for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                        _Sweep_lo[_Dim] = (_STD max)(_Lo[_Dim] > _Reach ? _Lo[_Dim] - _Reach : 0, _Radius) - _Origin[_Dim];
+                        _Sweep_hi[_Dim] =
+                            (_STD min)(_Hi[_Dim] + _Reach, _Src.extent(_Dim) - _Radius) - _Origin[_Dim];
+                    }
+
+                    _Stencil_sweep<_Shape>(_Cur, _Next, _Weights, _Sweep_lo, _Sweep_hi);
+                    _STD swap(_Cur, _Next);
+                }
+
+                array<size_t, _Rank> _Tile_origin;
+                array<size_t, _Rank> _Tile_size;
+                for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                    _Tile_origin[_Dim] = _Lo[_Dim] - _Origin[_Dim];
+                    _Tile_size[_Dim] = _Hi[_Dim] - _Lo[_Dim];
+                }
+                _Stencil_copy_box(_Cur, _Tile_origin, _Dst, _Lo, _Tile_size);
+            });
+    }
+
+    template <class _InSpan, class _OutSpan, class _Shape, class _Weight>
+    void _Stencil_apply(work_stealing_pool* const _Pool, const _InSpan& _In, const _OutSpan& _Out,
+        const array<_Weight, _Shape::size()>& _Weights, const stencil_blocking& _Blocking) {
+        static_assert(_InSpan::rank() == _Shape::rank() && _OutSpan::rank() == _Shape::rank(),
+            "The stencil shape must have the same rank as the mdspans.");
+        _STL_VERIFY(_In.extents() == _Out.extents(), "stencil_apply requires input and output of the same extents.");
+
+        _Stencil_for_each_tile<_Shape>(_Pool, _In.mapping(), _Blocking,
+            [&](const array<size_t, _Shape::rank()>& _Lo, const array<size_t, _Shape::rank()>& _Hi) {
+                _Stencil_sweep<_Shape>(_In, _Out, _Weights, _Lo, _Hi);
+            });
+    }
+
+    template <class _GridSpan, class _ScratchSpan, class _Shape, class _Weight>
+    void _Stencil_iterate(work_stealing_pool* const _Pool, const _GridSpan& _Grid, const _ScratchSpan& _Scratch,
+        const array<_Weight, _Shape::size()>& _Weights, size_t _Steps, const stencil_blocking& _Blocking) {
+        static_assert(_GridSpan::rank() == _Shape::rank() && _ScratchSpan::rank() == _Shape::rank(),
+            "The stencil shape must have the same rank as the mdspans.");
+        _STL_VERIFY(_Grid.extents() == _Scratch.extents(), "stencil_iterate requires buffers of the same extents.");
+
+        if (_Steps == 0) {
+            return;
+        }
+
+        _Stencil_copy_halo<_Shape>(_Grid, _Scratch);
+
+        const size_t _Fused = (_STD max)(size_t{1}, _Blocking.time_steps);
+        bool _In_grid = true;
+        while (_Steps > 0) {
+            const size_t _Now = (_STD min)(_Steps, _Fused);
+            if (_In_grid) {
+                _Stencil_fused_pass<_Shape>(_Pool, _Grid, _Scratch, _Weights, _Now, _Blocking);
+            }
+            else {
+                _Stencil_fused_pass<_Shape>(_Pool, _Scratch, _Grid, _Weights, _Now, _Blocking);
+            }
+
+            _In_grid = !_In_grid;
+            _Steps -= _Now;
+        }
+
+        if (!_In_grid) {
+            _Stencil_for_each_tile<_Shape>(_Pool, _Grid.mapping(), _Blocking,
+                [&](const array<size_t, _Shape::rank()>& _Lo, const array<size_t, _Shape::rank()>& _Hi) {
+                    array<size_t, _Shape::rank()> _Size;
+                    for (size_t _Dim = 0; _Dim < _Shape::rank(); ++_Dim) {
+                        _Size[_Dim] = _Hi[_Dim] - _Lo[_Dim];
+                    }
+                    _Stencil_copy_box(_Scratch, _Lo, _Grid, _Lo, _Size);
+                });
+        }
+    }
+
+    // Computes _Out(i) = sum_k _Weights[k] * _In(i + offsets[k]) for every i at least radius()
+    // away from the boundary. The outermost radius() points in each dimension are the halo: they are read but
+    // never written, and are filled by the caller with the boundary condition.
+    template <class _InSpan, class _OutSpan, class _Shape, class _Weight>
+    void stencil_apply(const _InSpan& _In, const _OutSpan& _Out, _Shape, const array<_Weight, _Shape::size()>& _Weights,
+        const stencil_blocking& _Blocking = {}) {
+        _Stencil_apply<_InSpan, _OutSpan, _Shape>(nullptr, _In, _Out, _Weights, _Blocking);
+    }
+
+    // As above, with the tiles distributed over _Pool.
+    template <class _InSpan, class _OutSpan, class _Shape, class _Weight>
+    void stencil_apply(work_stealing_pool& _Pool, const _InSpan& _In, const _OutSpan& _Out, _Shape,
+        const array<_Weight, _Shape::size()>& _Weights, const stencil_blocking& _Blocking = {}) {
+        _Stencil_apply<_InSpan, _OutSpan, _Shape>(&_Pool, _In, _Out, _Weights, _Blocking);
+    }
+
+    // Applies the stencil _Steps times to _Grid, using _Scratch (same extents) as the second
+    // buffer. The halo of _Grid is held fixed for all steps, so _Blocking.time_steps sweeps can be fused into
+    // one cache-blocked pass over memory. The result is left in _Grid.
+    template <class _GridSpan, class _ScratchSpan, class _Shape, class _Weight>
+    void stencil_iterate(const _GridSpan& _Grid, const _ScratchSpan& _Scratch, _Shape,
+        const array<_Weight, _Shape::size()>& _Weights, size_t _Steps, const stencil_blocking& _Blocking = {}) {
+        _Stencil_iterate<_GridSpan, _ScratchSpan, _Shape>(nullptr, _Grid, _Scratch, _Weights, _Steps, _Blocking);
+    }
+
+    // As above, with the tiles of each pass distributed over _Pool.
+    template <class _GridSpan, class _ScratchSpan, class _Shape, class _Weight>
+    void stencil_iterate(work_stealing_pool& _Pool, const _GridSpan& _Grid, const _ScratchSpan& _Scratch, _Shape,
+        const array<_Weight, _Shape::size()>& _Weights, size_t _Steps, const stencil_blocking& _Blocking = {}) {
+        _Stencil_iterate<_GridSpan, _ScratchSpan, _Shape>(&_Pool, _Grid, _Scratch, _Weights, _Steps, _Blocking);
+    }
+} // namespace std
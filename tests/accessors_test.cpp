@@ -0,0 +1,330 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "accessors.h"
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+TEST(accessors_tests, float16_codec) {
+    static_assert(float16_codec::encode(1.0f) == 0x3C00);
+    static_assert(float16_codec::encode(-2.0f) == 0xC000);
+    static_assert(float16_codec::encode(65504.0f) == 0x7BFF);
+    static_assert(float16_codec::encode(1e6f) == 0x7C00);
+    static_assert(float16_codec::encode(0x1p-24f) == 0x0001);
+    static_assert(float16_codec::encode(0x1p-26f) == 0x0000);
+    static_assert(float16_codec::decode(0x3555) == 0x1.554p-2f);
+    static_assert(float16_codec::decode(0x0001) == 0x1p-24f);
+
+    // Ties round to even.
+    static_assert(float16_codec::encode(1.0f + 0x1p-11f) == 0x3C00);
+    static_assert(float16_codec::encode(1.0f + 3 * 0x1p-11f) == 0x3C02);
+
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        const auto half = static_cast<uint16_t>(h);
+        if ((half & 0x7C00) == 0x7C00 && (half & 0x3FF)) {
+            EXPECT_TRUE(isnan(float16_codec::decode(half)));
+        } else {
+            EXPECT_EQ(float16_codec::encode(float16_codec::decode(half)), half);
+        }
+    }
+}
+
+TEST(accessors_tests, bfloat16_codec) {
+    static_assert(bfloat16_codec::encode(1.0f) == 0x3F80);
+    static_assert(bfloat16_codec::decode(0x4049) == 3.140625f);
+    static_assert(bfloat16_codec::encode(1.0f + 0x1p-8f) == 0x3F80);
+    static_assert(bfloat16_codec::encode(1.0f + 3 * 0x1p-8f) == 0x3F82);
+    EXPECT_TRUE(isnan(bfloat16_codec::decode(bfloat16_codec::encode(numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(accessors_tests, float16_mdspan) {
+    using E = dextents<size_t, 2>;
+    vector<uint16_t> storage(6);
+    mdspan<float, E, layout_right, float16_accessor<float>> m(storage.data(), 2, 3);
+    static_assert(sizeof(decltype(m)::pointer) == sizeof(void*));
+
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            m(i, j) = static_cast<float>(i * 3 + j) + 0.5f;
+        }
+    }
+    m(1, 2) += 1.0f;
+    EXPECT_EQ(storage[0], 0x3800);
+    EXPECT_EQ(static_cast<float>(m(1, 2)), 6.5f);
+
+    const mdspan<const float, E, layout_right, float16_accessor<const float>> c(
+        storage.data(), m.mapping(), m.accessor());
+    static_assert(is_same_v<decltype(c(0, 0)), float>);
+    EXPECT_EQ(c(0, 1), 1.5f);
+
+    vector<uint16_t> bf(4);
+    mdspan<float, dextents<size_t, 1>, layout_right, bfloat16_accessor<float>> b(bf.data(), 4);
+    b(3) = -2.0f;
+    EXPECT_EQ(bf[3], 0xC000);
+}
+
+TEST(accessors_tests, scaled) {
+    using E = dextents<size_t, 2>;
+    vector<int8_t> storage(6);
+
+    // Per tensor.
+    mdspan<float, E, layout_right, scaled_accessor<float>> m(storage.data(), layout_right::mapping<E>{E{2, 3}},
+        scaled_accessor<float>{0.5f});
+    m(0, 0) = 1.0f;
+    m(0, 1) = 1.3f;
+    m(0, 2) = 1000.0f;
+    m(1, 0) = -1000.0f;
+    EXPECT_EQ(storage[0], 2);
+    EXPECT_EQ(storage[1], 3);
+    EXPECT_EQ(storage[2], 127);
+    EXPECT_EQ(storage[3], -128);
+    EXPECT_EQ(static_cast<float>(m(0, 1)), 1.5f);
+
+    // NaN has no nearest integer; it stores 0.
+    m(1, 1) = 2.0f;
+    m(1, 1) = numeric_limits<float>::quiet_NaN();
+    EXPECT_EQ(storage[4], 0);
+    m(1, 2) = numeric_limits<float>::infinity();
+    EXPECT_EQ(storage[5], 127);
+
+    // Per row.
+    const float scales[] = {1.0f, 0.25f};
+    mdspan<float, E, layout_right, scaled_accessor<float>> rows(storage.data(), layout_right::mapping<E>{E{2, 3}},
+        scaled_accessor<float>{scales, 3});
+    rows(0, 2) = 5.0f;
+    rows(1, 2) = 5.0f;
+    EXPECT_EQ(storage[2], 5);
+    EXPECT_EQ(storage[5], 20);
+
+    // offset() carries the element index, so the row scale still applies.
+    const auto acc = rows.accessor();
+    const auto ptr = acc.offset(rows.data(), 4);
+    EXPECT_EQ(ptr.index, 4u);
+    EXPECT_EQ(static_cast<float>(acc.access(ptr, 1)), 5.0f);
+
+    const scaled_accessor<const float> const_acc(acc);
+    EXPECT_EQ(const_acc.access(ptr, 1), 5.0f);
+}
+
+TEST(accessors_tests, packed) {
+    vector<uint8_t> bits(bit_accessor<bool>::storage_size(20));
+    EXPECT_EQ(bits.size(), 3u);
+    mdspan<bool, dextents<size_t, 2>, layout_right, bit_accessor<bool>> mask(bits.data(), 4, 5);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            mask(i, j) = (i + j) % 3 == 0;
+        }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(static_cast<bool>(mask(i, j)), (i + j) % 3 == 0);
+        }
+    }
+    EXPECT_EQ(bits[0], 0b1000'1001);
+
+    vector<uint8_t> nibbles(nibble_accessor<uint8_t>::storage_size(5), 0xFF);
+    mdspan<uint8_t, dextents<size_t, 1>, layout_right, nibble_accessor<uint8_t>> n(nibbles.data(), 5);
+    for (size_t i = 0; i < 5; ++i) {
+        n(i) = static_cast<uint8_t>(i + 10);
+    }
+    EXPECT_EQ(nibbles, (vector<uint8_t>{0xBA, 0xDC, 0xFE}));
+
+    // Sub-byte offsets.
+    const nibble_accessor<const uint8_t> acc;
+    const auto ptr = acc.offset(n.data(), 3);
+    EXPECT_EQ(acc.access(ptr, 0), 13);
+    EXPECT_EQ(acc.access(acc.offset(ptr, 1), 0), 14);
+
+    mdspan<uint8_t, dextents<size_t, 1>, layout_right, packed_accessor<uint8_t, 2>> two(nibbles.data(), 4);
+    two(1) += 1;
+    EXPECT_EQ(nibbles[0], 0xBE);
+}
+
+TEST(accessors_tests, prefetch) {
+    using E = dextents<size_t, 2>;
+    vector<double> data(6 * 4);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<double>(i);
+    }
+    mdspan<double, E> m(data.data(), 6, 4);
+
+    const auto p = prefetch_along(m, 0, 3);
+    static_assert(is_same_v<decltype(p)::accessor_type, prefetch_accessor<double>>);
+    EXPECT_EQ(p.accessor().distance(), 12);
+    EXPECT_EQ(prefetch_along(m, 1, 3).accessor().distance(), 3);
+
+    double sum = 0;
+    for (size_t j = 0; j < 4; ++j) {
+        for (size_t i = 0; i < 6; ++i) {
+            sum += p(i, j);
+        }
+    }
+    EXPECT_EQ(sum, 276.0);
+
+    p(5, 3) = -1;
+    EXPECT_EQ(data[23], -1);
+
+    const prefetch_accessor<const double> c(p.accessor());
+    EXPECT_EQ(c.distance(), 12);
+    EXPECT_EQ(c.access(data.data(), 22), 22.0);
+}
+
+TEST(accessors_tests, profiling) {
+    using E = dextents<size_t, 2>;
+    vector<double> data(16 * 32);
+    mdspan<double, E> m(data.data(), 16, 32);
+
+    access_profile rows;
+    const auto by_rows = profile_accesses(m, rows);
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < 32; ++j) {
+            by_rows(i, j) = 1;
+        }
+    }
+    const auto row_report = rows.report();
+    EXPECT_EQ(row_report.accesses, 512u);
+    EXPECT_EQ(row_report.samples, 512u);
+    EXPECT_EQ(row_report.dominant_stride(), 1);
+    EXPECT_EQ(row_report.strides.at(1), 511u);
+    EXPECT_EQ(row_report.cold_accesses, 64u);
+    EXPECT_EQ(row_report.reuse_distances.size(), 1u);
+    EXPECT_EQ(row_report.reuse_distances[0], 448u);
+    EXPECT_DOUBLE_EQ(row_report.line_utilization, 1.0);
+
+    // The wrong way round: every access moves a whole row.
+    access_profile columns;
+    const auto by_columns = profile_accesses(m, columns);
+    for (size_t j = 0; j < 32; ++j) {
+        for (size_t i = 0; i < 16; ++i) {
+            by_columns(i, j) = 2;
+        }
+    }
+    const auto column_report = columns.report();
+    EXPECT_EQ(column_report.dominant_stride(), 32);
+    EXPECT_EQ(column_report.strides.at(32), 15u * 32u);
+    EXPECT_EQ(column_report.strides.at(-479), 31u);
+    // Each line comes back after the other 15 lines of its column: bucket [8, 16).
+    EXPECT_EQ(column_report.reuse_distances.size(), 5u);
+    EXPECT_EQ(column_report.reuse_distances[4], 448u);
+
+    // Sampling: bursts of 4 out of every 16 accesses, and only the first column.
+    access_profile sampled(access_sampling{4, 16, 1000, 64});
+    const auto s = profile_accesses(m, sampled);
+    double sum = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < 32; ++j) {
+            sum += s(i, j);
+        }
+    }
+    EXPECT_EQ(sum, 512.0 * 2);
+    const auto sampled_report = sampled.report();
+    EXPECT_EQ(sampled_report.accesses, 512u);
+    EXPECT_EQ(sampled_report.samples, 128u);
+    EXPECT_EQ(sampled_report.strides.size(), 1u);
+    EXPECT_EQ(sampled_report.strides.at(1), 96u);
+    EXPECT_DOUBLE_EQ(sampled_report.line_utilization, 0.5);
+
+    sampled.reset();
+    EXPECT_EQ(sampled.access_count(), 0u);
+    EXPECT_EQ(sampled.report().samples, 0u);
+
+    // Wrapping another accessor.
+    vector<uint16_t> halfs(4);
+    access_profile nested;
+    mdspan<float, dextents<size_t, 1>, layout_right, float16_accessor<float>> h(halfs.data(), 4);
+    const auto ph = profile_accesses(h, nested);
+    ph(2) = 0.5f;
+    EXPECT_EQ(halfs[2], 0x3800);
+    EXPECT_EQ(nested.access_count(), 1u);
+}
+
+TEST(accessors_tests, profiling_measures_storage) {
+    // 64 float16 elements are two 64-byte lines of storage, not the four their float values would fill.
+    vector<uint16_t> halfs(64);
+    mdspan<float, dextents<size_t, 1>, layout_right, float16_accessor<float>> h(halfs.data(), 64);
+    access_profile encoded;
+    const auto ph = profile_accesses(h, encoded);
+    for (size_t i = 0; i < 64; ++i) {
+        ph(i) = 1.0f;
+    }
+    EXPECT_EQ(encoded.report().cold_accesses, 2u);
+    EXPECT_DOUBLE_EQ(encoded.report().line_utilization, 1.0);
+
+    // 128 nibbles share one line.
+    vector<uint8_t> bytes(64);
+    mdspan<int, dextents<size_t, 1>, layout_right, nibble_accessor<int>> n(bytes.data(), 128);
+    access_profile packed;
+    const auto pn = profile_accesses(n, packed);
+    for (size_t i = 0; i < 128; ++i) {
+        pn(i) = 3;
+    }
+    EXPECT_EQ(packed.report().cold_accesses, 1u);
+    EXPECT_DOUBLE_EQ(packed.report().line_utilization, 1.0);
+
+    // Every fourth nibble touches a quarter of the line.
+    access_profile sparse;
+    const auto ps = profile_accesses(n, sparse);
+    for (size_t i = 0; i < 128; i += 4) {
+        (void) static_cast<int>(ps(i));
+    }
+    EXPECT_DOUBLE_EQ(sparse.report().line_utilization, 0.25);
+}
+
+struct particle {
+    float x;
+    float y;
+    float z;
+    double m;
+};
+
+TEST(accessors_tests, soa) {
+    using A = soa_accessor<particle, &particle::x, &particle::y, &particle::z, &particle::m>;
+    using E = dextents<size_t, 2>;
+    static_assert(A::field_index<&particle::z>() == 2);
+    static_assert(A::field_index<&particle::m>() == 3);
+
+    vector<float> xs(6);
+    vector<float> ys(6);
+    vector<float> zs(6);
+    vector<double> ms(6);
+    mdspan<particle, E, layout_right, A> p(A::pointer{xs.data(), ys.data(), zs.data(), ms.data()}, 2, 3);
+
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            const auto f = static_cast<float>(i * 3 + j);
+            p(i, j) = particle{f, f + 10, f + 20, f * 0.5};
+        }
+    }
+    EXPECT_EQ(ys[4], 14.0f);
+    EXPECT_EQ(ms[5], 2.5);
+    EXPECT_EQ(static_cast<particle>(p(1, 1)).z, 24.0f);
+
+    // Per-field views share the mapping.
+    const auto xv = soa_field<&particle::x>(p);
+    static_assert(is_same_v<decltype(xv), const mdspan<float, E>>);
+    EXPECT_EQ(xv.mapping(), p.mapping());
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            xv(i, j) *= 2;
+        }
+    }
+    EXPECT_EQ(static_cast<particle>(p(1, 2)).x, 10.0f);
+
+    // A subset of members, read-only, in layout_left.
+    using C = soa_accessor<const particle, &particle::m, &particle::x>;
+    const mdspan<const particle, E, layout_left, C> c(C::pointer{ms.data(), xs.data()}, 3, 2);
+    static_assert(is_same_v<decltype(c(0, 0)), particle>);
+    EXPECT_EQ(c(2, 1).m, 2.5);
+    EXPECT_EQ(c(2, 1).x, 10.0f);
+    EXPECT_EQ(c(2, 1).y, 0.0f);
+    const auto mv = soa_field<&particle::m>(c);
+    static_assert(is_same_v<decltype(mv)::element_type, const double>);
+    EXPECT_EQ(mv(1, 1), 2.0);
+
+    const auto shifted = c.accessor().offset(c.data(), 4);
+    EXPECT_EQ(get<0>(shifted), ms.data() + 4);
+    EXPECT_EQ(c.accessor().access(shifted, 1).x, 10.0f);
+}
@@ -0,0 +1,97 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "arena.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+TEST(arena_tests, bump) {
+    arena a(1024);
+    EXPECT_EQ(a.capacity(), 0u);
+
+    void* const p1 = a.allocate(10);
+    void* const p2 = a.allocate(10);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) % arena::default_alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % arena::default_alignment, 0u);
+    EXPECT_EQ(static_cast<char*>(p2) - static_cast<char*>(p1), 64);
+    EXPECT_EQ(a.capacity(), 1024u);
+    EXPECT_EQ(a.bytes_used(), 74u);
+
+    void* const tight = a.allocate(1, 1);
+    EXPECT_EQ(static_cast<char*>(tight), static_cast<char*>(p2) + 10);
+
+    void* const wide = a.allocate(8, 256);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wide) % 256, 0u);
+
+    // Larger than a chunk.
+    void* const big = a.allocate(5000);
+    EXPECT_NE(big, nullptr);
+    EXPECT_EQ(a.capacity(), 1024u + 5000u);
+
+    // Reset keeps the chunks, and the same sequence lands in the same places.
+    a.reset();
+    EXPECT_EQ(a.bytes_used(), 0u);
+    EXPECT_EQ(a.allocate(10), p1);
+    EXPECT_EQ(a.allocate(10), p2);
+    EXPECT_EQ(a.capacity(), 1024u + 5000u);
+}
+
+TEST(arena_tests, scopes) {
+    arena a(4096);
+    void* const outer = a.allocate(100);
+    const size_t used = a.bytes_used();
+    void* inner = nullptr;
+    {
+        arena_scope scope(a);
+        inner = a.allocate(3000);
+        {
+            arena_scope nested(a);
+            (void) a.allocate(3000); // spills into a second chunk
+            EXPECT_EQ(a.capacity(), 8192u);
+        }
+        EXPECT_EQ(a.allocate(16), static_cast<char*>(inner) + 3008);
+    }
+    EXPECT_EQ(a.bytes_used(), used);
+    EXPECT_EQ(a.allocate(3000), inner);
+    EXPECT_NE(outer, inner);
+}
+
+TEST(arena_tests, allocator) {
+    arena a(1 << 16);
+    {
+        arena_scope scope(a);
+        vector<double, arena_allocator<double>> v(100, 1.5, arena_allocator<double>(a));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(v.data()) % arena::default_alignment, 0u);
+        EXPECT_GE(a.bytes_used(), 800u);
+        v.push_back(2.0);
+        EXPECT_EQ(v[100], 2.0);
+
+        const arena_allocator<int> other(v.get_allocator());
+        EXPECT_TRUE(other == v.get_allocator());
+        EXPECT_FALSE(other == arena_allocator<int>(thread_arena()));
+    }
+    EXPECT_EQ(a.bytes_used(), 0u);
+}
+
+TEST(arena_tests, mdarray) {
+    arena& a = thread_arena();
+    const size_t before = a.bytes_used();
+    {
+        arena_scope scope;
+        arena_mdarray<float, dextents<size_t, 2>> t(64, 32);
+        EXPECT_EQ(a.bytes_used() - before, 64u * 32u * sizeof(float));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(t.data()) % arena::default_alignment, 0u);
+        t(63, 31) = 4.0f;
+
+        mdspan<float, dextents<size_t, 2>> view = t;
+        EXPECT_EQ(view(63, 31), 4.0f);
+
+        arena_mdarray<double, extents<size_t, 8, 8>, layout_left> small;
+        EXPECT_EQ(small.size(), 64u);
+        EXPECT_EQ(small(7, 7), 0.0);
+    }
+    EXPECT_EQ(a.bytes_used(), before);
+}
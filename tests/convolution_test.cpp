@@ -0,0 +1,170 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "convolution.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+using E4 = dextents<size_t, 4>;
+using K3x3 = extents<size_t, dynamic_extent, dynamic_extent, 3, 3>;
+
+namespace {
+    // Reference correlation of an NCHW image with an OIHW kernel.
+    vector<float> reference(const vector<float>& in, const vector<float>& kernel, const size_t n, const size_t c,
+        const size_t h, const size_t w, const size_t k, const size_t r, const size_t s, const size_t stride,
+        const size_t pad) {
+        const size_t p = (h + 2 * pad - r) / stride + 1;
+        const size_t q = (w + 2 * pad - s) / stride + 1;
+        vector<float> out(n * k * p * q);
+        for (size_t b = 0; b < n; ++b) {
+            for (size_t o = 0; o < k; ++o) {
+                for (size_t y = 0; y < p; ++y) {
+                    for (size_t x = 0; x < q; ++x) {
+                        float sum = 0;
+                        for (size_t ch = 0; ch < c; ++ch) {
+                            for (size_t i = 0; i < r; ++i) {
+                                for (size_t j = 0; j < s; ++j) {
+                                    const auto row = static_cast<ptrdiff_t>(y * stride + i - pad);
+                                    const auto col = static_cast<ptrdiff_t>(x * stride + j - pad);
+                                    if (row >= 0 && col >= 0 && row < static_cast<ptrdiff_t>(h)
+                                        && col < static_cast<ptrdiff_t>(w)) {
+                                        sum += in[((b * c + ch) * h + static_cast<size_t>(row)) * w
+                                                  + static_cast<size_t>(col)]
+                                             * kernel[((o * c + ch) * r + i) * s + j];
+                                    }
+                                }
+                            }
+                        }
+                        out[((b * k + o) * p + y) * q + x] = sum;
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
+    vector<float> sample(const size_t size, const float scale) {
+        vector<float> result(size);
+        for (size_t i = 0; i < size; ++i) {
+            result[i] = static_cast<float>(sin(scale * static_cast<double>(i + 1)));
+        }
+        return result;
+    }
+} // namespace
+
+TEST(convolution_tests, algorithms_match_reference) {
+    const size_t n = 2, c = 3, h = 7, w = 6, k = 4;
+    const auto in = sample(n * c * h * w, 0.7f);
+    const auto weights = sample(k * c * 9, 1.9f);
+    mdspan<const float, E4> x(in.data(), n, c, h, w);
+    mdspan<const float, K3x3> g(weights.data(), k, c);
+
+    for (const size_t pad : {0u, 1u}) {
+        const auto expected = reference(in, weights, n, c, h, w, k, 3, 3, 1, pad);
+        const size_t p = h + 2 * pad - 2;
+        const size_t q = w + 2 * pad - 2;
+        for (const auto algorithm : {conv2d_algorithm::automatic, conv2d_algorithm::direct, conv2d_algorithm::im2col,
+                 conv2d_algorithm::winograd}) {
+            vector<float> out(n * k * p * q);
+            mdspan<float, E4> y(out.data(), n, k, p, q);
+            correlate2d(x, g, y, nchw, {1, pad, algorithm});
+            for (size_t i = 0; i < out.size(); ++i) {
+                EXPECT_NEAR(out[i], expected[i], 1e-4f)
+                    << "pad " << pad << " algorithm " << static_cast<int>(algorithm);
+            }
+        }
+    }
+}
+
+TEST(convolution_tests, nhwc_and_stride) {
+    const size_t n = 1, c = 2, h = 9, w = 8, k = 3, r = 2, s = 3;
+    const auto in = sample(n * c * h * w, 0.3f);
+    const auto weights = sample(k * c * r * s, 1.1f);
+    const auto expected = reference(in, weights, n, c, h, w, k, r, s, 2, 1);
+    const size_t p = (h + 2 - r) / 2 + 1;
+    const size_t q = (w + 2 - s) / 2 + 1;
+
+    // The same image, channels last and without a batch dimension.
+    vector<float> hwc(in.size());
+    for (size_t ch = 0; ch < c; ++ch) {
+        for (size_t i = 0; i < h * w; ++i) {
+            hwc[i * c + ch] = in[ch * h * w + i];
+        }
+    }
+    mdspan<const float, dextents<size_t, 3>> x(hwc.data(), h, w, c);
+    mdspan<const float, E4> g(weights.data(), k, c, r, s);
+    vector<float> out(p * q * k);
+    mdspan<float, dextents<size_t, 3>> y(out.data(), p, q, k);
+
+    work_stealing_pool pool(3);
+    correlate2d(pool, x, g, y, nhwc, {2, 1});
+    for (size_t o = 0; o < k; ++o) {
+        for (size_t i = 0; i < p; ++i) {
+            for (size_t j = 0; j < q; ++j) {
+                EXPECT_NEAR(y(i, j, o), expected[(o * p + i) * q + j], 1e-4f);
+            }
+        }
+    }
+}
+
+TEST(convolution_tests, convolve_flips_kernel) {
+    const size_t c = 1, h = 5, w = 5, k = 1;
+    const auto in = sample(c * h * w, 0.9f);
+    vector<float> weights(9);
+    weights[0] = 1; // Top-left tap.
+    mdspan<const float, dextents<size_t, 3>> x(in.data(), c, h, w);
+    mdspan<const float, K3x3> g(weights.data(), k, c);
+    vector<float> out(k * 3 * 3);
+    mdspan<float, dextents<size_t, 3>> y(out.data(), k, 3, 3);
+
+    convolve2d(x, g, y, nchw);
+    // Convolution with a kernel that is 1 only at (0, 0) picks the input at offset (2, 2).
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(y(0, i, j), in[(i + 2) * w + j + 2], 1e-6f);
+        }
+    }
+
+    correlate2d(x, g, y, nchw);
+    EXPECT_NEAR(y(0, 1, 1), in[1 * w + 1], 1e-6f);
+}
+
+TEST(convolution_tests, parallel_batches) {
+    const size_t n = 5, c = 4, h = 10, w = 10, k = 6;
+    const auto in = sample(n * c * h * w, 0.11f);
+    const auto weights = sample(k * c, 2.3f);
+    mdspan<const float, E4> x(in.data(), n, c, h, w);
+    mdspan<const float, extents<size_t, dynamic_extent, dynamic_extent, 1, 1>> g(weights.data(), k, c);
+    const auto expected = reference(in, weights, n, c, h, w, k, 1, 1, 1, 0);
+
+    vector<float> out(n * k * h * w);
+    mdspan<float, E4> y(out.data(), n, k, h, w);
+    work_stealing_pool pool(4);
+    correlate2d(pool, x, g, y, nchw);
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], expected[i], 1e-4f);
+    }
+}
+
+TEST(convolution_tests, parallel_channels_share_transforms) {
+    // Fewer images than tasks, so the output channels are split; more channels and pixels than one product block.
+    const size_t n = 2, c = 3, h = 20, w = 19, k = 11;
+    const auto in = sample(n * c * h * w, 0.23f);
+    const auto weights = sample(k * c * 9, 1.7f);
+    mdspan<const float, E4> x(in.data(), n, c, h, w);
+    mdspan<const float, K3x3> g(weights.data(), k, c);
+    const auto expected = reference(in, weights, n, c, h, w, k, 3, 3, 1, 1);
+
+    work_stealing_pool pool(4);
+    for (const auto algorithm : {conv2d_algorithm::im2col, conv2d_algorithm::winograd}) {
+        vector<float> out(n * k * h * w);
+        mdspan<float, E4> y(out.data(), n, k, h, w);
+        correlate2d(pool, x, g, y, nchw, {1, 1, algorithm});
+        for (size_t i = 0; i < out.size(); ++i) {
+            EXPECT_NEAR(out[i], expected[i], 1e-4f) << "algorithm " << static_cast<int>(algorithm);
+        }
+    }
+}
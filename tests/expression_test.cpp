@@ -0,0 +1,139 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "expression.h"
+#include "accessors.h"
+#include <vector>
+
+using namespace std;
+
+using E = dextents<size_t, 2>;
+
+vector<double> ramp(size_t n, double start) {
+    vector<double> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = start + static_cast<double>(i);
+    }
+    return v;
+}
+
+TEST(expression_tests, flat) {
+    auto a_data = ramp(12, 1);
+    auto b_data = ramp(12, 2);
+    auto c_data = ramp(12, 3);
+    vector<double> out(12);
+    mdspan<double, E> a(a_data.data(), 3, 4);
+    mdspan<double, E> b(b_data.data(), 3, 4);
+    mdspan<const double, E> c(c_data.data(), 3, 4);
+    mdspan<double, E> d(out.data(), 3, 4);
+
+    const auto expr = a + b * c;
+    static_assert(is_same_v<decltype(expr)::value_type, double>);
+    EXPECT_EQ(expr(1, 2), a(1, 2) + b(1, 2) * c(1, 2));
+
+    evaluate_into(d, expr);
+    for (size_t i = 0; i < 12; ++i) {
+        EXPECT_EQ(out[i], a_data[i] + b_data[i] * c_data[i]);
+    }
+
+    // Scalars, unary minus, and the destination as an operand.
+    evaluate_into(d, -(d - 2.0) / 2 + 1);
+    for (size_t i = 0; i < 12; ++i) {
+        EXPECT_EQ(out[i], -(a_data[i] + b_data[i] * c_data[i] - 2.0) / 2 + 1);
+    }
+
+    evaluate_into(d, 0.0);
+    EXPECT_EQ(out, vector<double>(12, 0.0));
+    evaluate_into(d, a);
+    EXPECT_EQ(out, a_data);
+}
+
+TEST(expression_tests, rank_0) {
+    double x = 3, y = 4, z = 0;
+    mdspan<double, extents<size_t>> a(&x);
+    mdspan<const double, extents<size_t>> b(&y);
+    // A layout_left destination doesn't share the operands' mapping type, so it takes the walk.
+    mdspan<double, extents<size_t>, layout_left> c(&z);
+    evaluate_into(c, a * b + 1.0);
+    EXPECT_EQ(z, 13.0);
+    evaluate_into(a, 2.0);
+    EXPECT_EQ(x, 2.0);
+}
+
+TEST(expression_tests, mixed_layouts) {
+    auto a_data = ramp(12, 1);
+    auto b_data = ramp(12, 100);
+    mdspan<double, E> a(a_data.data(), 3, 4);
+    mdspan<double, E, layout_left> b(b_data.data(), 3, 4);
+
+    // A padded destination.
+    vector<double> out(3 * 6, -1);
+    const layout_stride::mapping<E> padded{E{3, 4}, array<size_t, 2>{6, 1}};
+    mdspan<double, E, layout_stride> d(out.data(), padded);
+
+    evaluate_into(d, a * 2 - b);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 6; ++j) {
+            EXPECT_EQ(out[i * 6 + j], j < 4 ? a(i, j) * 2 - b(i, j) : -1);
+        }
+    }
+
+    // layout_left destination with layout_right operands.
+    vector<double> left(12);
+    mdspan<double, E, layout_left> l(left.data(), 3, 4);
+    evaluate_into(l, a + a);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(l(i, j), 2 * a(i, j));
+        }
+    }
+}
+
+TEST(expression_tests, accessors_and_types) {
+    vector<uint16_t> halfs(6);
+    mdspan<float, dextents<size_t, 1>, layout_right, float16_accessor<float>> h(halfs.data(), 6);
+    vector<int> ints{1, 2, 3, 4, 5, 6};
+    mdspan<int, dextents<size_t, 1>> n(ints.data(), 6);
+
+    const auto expr = n * 0.5f;
+    static_assert(is_same_v<decltype(expr)::value_type, float>);
+    evaluate_into(h, expr);
+    EXPECT_EQ(halfs[0], 0x3800);
+    EXPECT_EQ(static_cast<float>(h(5)), 3.0f);
+
+    vector<double> out(6);
+    mdspan<double, dextents<size_t, 1>> o(out.data(), 6);
+    evaluate_into(o, h + n);
+    EXPECT_EQ(out[3], 6.0);
+}
+
+TEST(expression_tests, broadcast_operands) {
+    vector<double> x(3 * 4);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<double>(i);
+    }
+    const double col_bias[4] = {10, 20, 30, 40};
+    const double row_scale[3] = {1, 2, 3};
+    mdspan<double, E> a(x.data(), 3, 4);
+    const auto bias = broadcast<0>(mdspan<const double, dextents<size_t, 1>>(col_bias, 4), E{3, 4});
+    const auto scale = broadcast<1>(mdspan<const double, dextents<size_t, 1>>(row_scale, 3), E{3, 4});
+
+    vector<double> out(3 * 4);
+    mdspan<double, E> y(out.data(), 3, 4);
+    evaluate_into(y, a * scale + bias);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(y(i, j), a(i, j) * row_scale[i] + col_bias[j]);
+        }
+    }
+
+    // In place, with the broadcast dimension innermost for the destination, so each scale is read once per row.
+    const vector<double> before = out;
+    evaluate_into(y, y - scale);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(y(i, j), before[i * 4 + j] - row_scale[i]);
+        }
+    }
+}
@@ -0,0 +1,153 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "fft.h"
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <vector>
+
+using namespace std;
+
+using cd = complex<double>;
+
+namespace {
+    vector<cd> naive_dft(const vector<cd>& x) {
+        const size_t n = x.size();
+        vector<cd> result(n);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t j = 0; j < n; ++j) {
+                result[k] += x[j] * polar(1.0, -2 * numbers::pi * static_cast<double>((j * k) % n) / n);
+            }
+        }
+        return result;
+    }
+
+    vector<cd> sample(const size_t n, const size_t seed) {
+        vector<cd> x(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = {sin(0.37 * static_cast<double>(i + seed)), cos(1.3 * static_cast<double>(i * seed + 1))};
+        }
+        return x;
+    }
+} // namespace
+
+TEST(fft_tests, lines_along_each_axis) {
+    for (const size_t rows : {8u, 6u}) {
+        for (const size_t cols : {16u, 5u}) {
+            const vector<cd> original = sample(rows * cols, rows + cols);
+            for (size_t axis = 0; axis < 2; ++axis) {
+                vector<cd> data = original;
+                mdspan<cd, dextents<size_t, 2>> m(data.data(), rows, cols);
+                fft(m, axis);
+
+                const size_t lines = axis == 0 ? cols : rows;
+                const size_t length = axis == 0 ? rows : cols;
+                for (size_t line = 0; line < lines; ++line) {
+                    vector<cd> x(length);
+                    for (size_t i = 0; i < length; ++i) {
+                        x[i] = axis == 0 ? original[i * cols + line] : original[line * cols + i];
+                    }
+                    const auto expected = naive_dft(x);
+                    for (size_t i = 0; i < length; ++i) {
+                        const cd actual = axis == 0 ? m(i, line) : m(line, i);
+                        EXPECT_NEAR(abs(actual - expected[i]), 0.0, 1e-9) << rows << 'x' << cols << " axis " << axis;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(fft_tests, round_trip_3d) {
+    const vector<cd> original = sample(4 * 3 * 8, 7);
+    vector<cd> data = original;
+    mdspan<cd, dextents<size_t, 3>, layout_left> m(data.data(), 4, 3, 8);
+    fft(m);
+    fft(m, fft_direction::backward);
+    for (size_t i = 0; i < data.size(); ++i) {
+        EXPECT_NEAR(abs(data[i] - original[i]), 0.0, 1e-12);
+    }
+}
+
+TEST(fft_tests, separable_2d_matches_parallel) {
+    const vector<cd> original = sample(40 * 24, 3);
+    vector<cd> serial = original;
+    vector<cd> parallel = original;
+    mdspan<cd, dextents<size_t, 2>> s(serial.data(), 40, 24);
+    mdspan<cd, dextents<size_t, 2>> p(parallel.data(), 40, 24);
+
+    work_stealing_pool pool(4);
+    fft(s);
+    fft(pool, p);
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_NEAR(abs(serial[i] - parallel[i]), 0.0, 1e-12);
+    }
+
+    // A 2-D DC term is the sum of everything.
+    cd sum{};
+    for (const cd& v : original) {
+        sum += v;
+    }
+    EXPECT_NEAR(abs(s(0, 0) - sum), 0.0, 1e-9);
+}
+
+TEST(fft_tests, real_to_complex) {
+    for (const size_t n : {8u, 12u, 7u}) {
+        const size_t lines = 3;
+        vector<double> in(lines * n);
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = cos(0.21 * static_cast<double>(i * i)) + 0.5;
+        }
+        // Transform along dimension 0 of a layout_right span, so the axis is not unit-stride.
+        mdspan<double, dextents<size_t, 2>> x(in.data(), n, lines);
+        vector<cd> out((n / 2 + 1) * lines);
+        mdspan<cd, dextents<size_t, 2>> y(out.data(), n / 2 + 1, lines);
+        rfft(x, y, 0);
+
+        for (size_t line = 0; line < lines; ++line) {
+            vector<cd> line_data(n);
+            for (size_t i = 0; i < n; ++i) {
+                line_data[i] = x(i, line);
+            }
+            const auto expected = naive_dft(line_data);
+            for (size_t k = 0; k <= n / 2; ++k) {
+                EXPECT_NEAR(abs(y(k, line) - expected[k]), 0.0, 1e-9) << "n = " << n;
+            }
+        }
+    }
+}
+
+TEST(fft_tests, real_to_complex_nd) {
+    // More lines than one gather block, with an even and an odd last extent.
+    for (const size_t n : {12u, 9u}) {
+        const size_t planes = 3;
+        const size_t rows = 20;
+        vector<double> in(planes * rows * n);
+        vector<cd> full(in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = sin(0.13 * static_cast<double>(i * i % 97)) - 0.25;
+            full[i] = in[i];
+        }
+        mdspan<double, dextents<size_t, 3>> x(in.data(), planes, rows, n);
+        mdspan<cd, dextents<size_t, 3>> expected(full.data(), planes, rows, n);
+        fft(expected);
+
+        vector<cd> serial(planes * rows * (n / 2 + 1));
+        vector<cd> parallel(serial.size());
+        mdspan<cd, dextents<size_t, 3>> s(serial.data(), planes, rows, n / 2 + 1);
+        mdspan<cd, dextents<size_t, 3>> p(parallel.data(), planes, rows, n / 2 + 1);
+        work_stealing_pool pool(4);
+        rfft(x, s);
+        rfft(pool, x, p);
+        for (size_t i = 0; i < planes; ++i) {
+            for (size_t j = 0; j < rows; ++j) {
+                for (size_t k = 0; k <= n / 2; ++k) {
+                    EXPECT_NEAR(abs(s(i, j, k) - expected(i, j, k)), 0.0, 1e-9) << "n = " << n;
+                    EXPECT_NEAR(abs(p(i, j, k) - s(i, j, k)), 0.0, 1e-12) << "n = " << n;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "histogram.h"
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+TEST(histogram_tests, uniform_bins) {
+    const uniform_bins<int> shifted(-8, 8, 4);
+    EXPECT_EQ(shifted.size(), 4u);
+    EXPECT_EQ(shifted.bin(-8), 0u);
+    EXPECT_EQ(shifted.bin(-5), 0u);
+    EXPECT_EQ(shifted.bin(-4), 1u);
+    EXPECT_EQ(shifted.bin(7), 3u);
+    EXPECT_EQ(shifted.bin(8), 4u);
+    EXPECT_EQ(shifted.bin(-9), 4u);
+
+    const uniform_bins<unsigned> divided(0, 30, 3);
+    EXPECT_EQ(divided.bin(9), 0u);
+    EXPECT_EQ(divided.bin(10), 1u);
+    EXPECT_EQ(divided.bin(29), 2u);
+
+    const uniform_bins<int> uneven(0, 10, 3);
+    EXPECT_EQ(uneven.bin(3), 0u);
+    EXPECT_EQ(uneven.bin(4), 1u);
+    EXPECT_EQ(uneven.bin(9), 2u);
+
+    const uniform_bins<double> real(0.0, 1.0, 10);
+    EXPECT_EQ(real.bin(0.0), 0u);
+    EXPECT_EQ(real.bin(0.35), 3u);
+    EXPECT_EQ(real.bin(nextafter(1.0, 0.0)), 9u);
+    EXPECT_EQ(real.bin(1.0), 10u);
+    EXPECT_EQ(real.bin(nan("")), 10u);
+}
+
+TEST(histogram_tests, variable_bins_1d) {
+    const variable_bins<double> bins({0.0, 1.0, 10.0, 100.0});
+    EXPECT_EQ(bins.bin(0.5), 0u);
+    EXPECT_EQ(bins.bin(1.0), 1u);
+    EXPECT_EQ(bins.bin(99.0), 2u);
+    EXPECT_EQ(bins.bin(100.0), 3u);
+
+    const vector<double> data{0.1, 5.0, 50.0, 2.0, -1.0, 1000.0, 0.9};
+    mdspan<const double, dextents<size_t, 1>> samples(data.data(), data.size());
+    vector<int> storage{1, 1, 1};
+    mdspan<int, dextents<size_t, 1>> counts(storage.data(), 3);
+    histogram(samples, counts, bins);
+
+    // Counts are added to.
+    EXPECT_EQ(counts(0), 3);
+    EXPECT_EQ(counts(1), 3);
+    EXPECT_EQ(counts(2), 2);
+}
+
+TEST(histogram_tests, parallel_2d_matches_serial) {
+    const size_t n = 100000;
+    vector<double> data(n * 2);
+    for (size_t i = 0; i < n; ++i) {
+        data[2 * i] = sin(0.001 * static_cast<double>(i)) * 1.1;
+        data[2 * i + 1] = cos(0.0007 * static_cast<double>(i * i % 10007));
+    }
+    mdspan<const double, dextents<size_t, 2>> samples(data.data(), n, 2);
+    const uniform_bins<double> x(-1.0, 1.0, 16);
+    const variable_bins<double> y({-1.0, -0.5, 0.0, 0.25, 0.5, 1.0});
+
+    vector<long long> serial(16 * 5);
+    mdspan<long long, extents<size_t, 16, 5>> serial_counts(serial.data());
+    histogram(samples, serial_counts, x, y);
+
+    // A column-major count array exercises the mapping in the merge.
+    vector<long long> parallel(16 * 5);
+    mdspan<long long, dextents<size_t, 2>, layout_left> parallel_counts(parallel.data(), 16, 5);
+    work_stealing_pool pool(4);
+    histogram(pool, samples, parallel_counts, x, y);
+
+    long long total = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(serial_counts(i, j), parallel_counts(i, j));
+            total += serial_counts(i, j);
+        }
+    }
+
+    long long expected = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (x.bin(samples(i, 0)) < x.size() && y.bin(samples(i, 1)) < y.size()) {
+            ++expected;
+        }
+    }
+    EXPECT_EQ(total, expected);
+    EXPECT_LT(total, static_cast<long long>(n));
+}
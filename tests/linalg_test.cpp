@@ -0,0 +1,171 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "linalg.h"
+#include <vector>
+
+using namespace std;
+
+using E3 = dextents<size_t, 3>;
+using E2 = dextents<size_t, 2>;
+
+template <class Span>
+void fill_batch(const Span& m, size_t seed) {
+    for (size_t b = 0; b < m.extent(0); ++b) {
+        for (size_t i = 0; i < m.extent(1); ++i) {
+            for (size_t j = 0; j < m.extent(2); ++j) {
+                m(b, i, j) = static_cast<double>((b * 7 + i * 3 + j * 5 + seed) % 11) - 5;
+            }
+        }
+    }
+}
+
+template <class Layout>
+void check_gemm(work_stealing_pool* pool) {
+    constexpr size_t batch = 37;
+    constexpr size_t m = 5;
+    constexpr size_t k = 4;
+    constexpr size_t n = 6;
+    vector<double> a_data(batch * m * k);
+    vector<double> b_data(batch * k * n);
+    vector<double> c_data(batch * m * n, -1);
+    mdspan<double, E3, Layout> a(a_data.data(), batch, m, k);
+    mdspan<double, E3, Layout> b(b_data.data(), batch, k, n);
+    mdspan<double, E3, Layout> c(c_data.data(), batch, m, n);
+    fill_batch(a, 1);
+    fill_batch(b, 2);
+
+    if (pool) {
+        batched_gemm(*pool, a, b, c);
+    } else {
+        batched_gemm(a, b, c);
+    }
+
+    for (size_t p = 0; p < batch; ++p) {
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double expected = 0;
+                for (size_t q = 0; q < k; ++q) {
+                    expected += a(p, i, q) * b(p, q, j);
+                }
+                EXPECT_EQ(c(p, i, j), expected);
+            }
+        }
+    }
+}
+
+TEST(linalg_tests, batched_gemm) {
+    check_gemm<layout_right>(nullptr);
+    check_gemm<layout_left>(nullptr);
+
+    work_stealing_pool pool(3);
+    check_gemm<layout_right>(&pool);
+    check_gemm<layout_left>(&pool);
+}
+
+template <class Layout>
+void check_gemv(work_stealing_pool* pool) {
+    constexpr size_t batch = 50;
+    constexpr size_t m = 3;
+    constexpr size_t n = 7;
+    vector<double> a_data(batch * m * n);
+    vector<double> x_data(batch * n);
+    vector<double> y_data(batch * m, -1);
+    mdspan<double, E3, Layout> a(a_data.data(), batch, m, n);
+    mdspan<double, E2, Layout> x(x_data.data(), batch, n);
+    mdspan<double, E2, Layout> y(y_data.data(), batch, m);
+    fill_batch(a, 3);
+    for (size_t p = 0; p < batch; ++p) {
+        for (size_t j = 0; j < n; ++j) {
+            x(p, j) = static_cast<double>(p + j);
+        }
+    }
+
+    if (pool) {
+        batched_gemv(*pool, a, x, y);
+    } else {
+        batched_gemv(a, x, y);
+    }
+
+    for (size_t p = 0; p < batch; ++p) {
+        for (size_t i = 0; i < m; ++i) {
+            double expected = 0;
+            for (size_t j = 0; j < n; ++j) {
+                expected += a(p, i, j) * x(p, j);
+            }
+            EXPECT_EQ(y(p, i), expected);
+        }
+    }
+}
+
+TEST(linalg_tests, batched_gemv) {
+    check_gemv<layout_right>(nullptr);
+    check_gemv<layout_left>(nullptr);
+
+    work_stealing_pool pool(2);
+    check_gemv<layout_left>(&pool);
+}
+
+template <class Layout, class Triangle>
+void check_trsm(Triangle triangle, work_stealing_pool* pool) {
+    constexpr bool lower = is_same_v<Triangle, lower_triangle_t>;
+    constexpr size_t batch = 19;
+    constexpr size_t n = 8;
+    constexpr size_t rhs = 3;
+    vector<double> a_data(batch * n * n);
+    vector<double> x_data(batch * n * rhs);
+    vector<double> b_data(batch * n * rhs);
+    mdspan<double, E3, Layout> a(a_data.data(), batch, n, n);
+    mdspan<double, E3, Layout> x(x_data.data(), batch, n, rhs);
+    mdspan<double, E3, Layout> b(b_data.data(), batch, n, rhs);
+    fill_batch(a, 4);
+    fill_batch(x, 5);
+
+    // Strong diagonal; garbage in the other triangle, which must be ignored.
+    for (size_t p = 0; p < batch; ++p) {
+        for (size_t i = 0; i < n; ++i) {
+            a(p, i, i) = 16.0 + static_cast<double>(p % 3);
+            for (size_t j = 0; j < n; ++j) {
+                if (lower ? j > i : j < i) {
+                    a(p, i, j) = 1e6;
+                }
+            }
+        }
+    }
+
+    for (size_t p = 0; p < batch; ++p) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < rhs; ++j) {
+                double sum = 0;
+                for (size_t q = 0; q < n; ++q) {
+                    if (lower ? q <= i : q >= i) {
+                        sum += a(p, i, q) * x(p, q, j);
+                    }
+                }
+                b(p, i, j) = sum;
+            }
+        }
+    }
+
+    if (pool) {
+        batched_trsm(*pool, a, triangle, b);
+    } else {
+        batched_trsm(a, triangle, b);
+    }
+
+    for (size_t i = 0; i < b_data.size(); ++i) {
+        EXPECT_NEAR(b_data[i], x_data[i], 1e-12) << i;
+    }
+}
+
+TEST(linalg_tests, batched_trsm) {
+    check_trsm<layout_right>(lower_triangle, nullptr);
+    check_trsm<layout_right>(upper_triangle, nullptr);
+    check_trsm<layout_left>(lower_triangle, nullptr);
+    check_trsm<layout_left>(upper_triangle, nullptr);
+
+    work_stealing_pool pool(2);
+    check_trsm<layout_right>(upper_triangle, &pool);
+    check_trsm<layout_left>(lower_triangle, &pool);
+}
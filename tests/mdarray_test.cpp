@@ -0,0 +1,71 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "mdarray.h"
+#include <type_traits>
+
+using namespace std;
+
+TEST(mdarray_tests, traits) {
+    using A = mdarray<int, extents<size_t, 2, dynamic_extent>>;
+    static_assert(is_same_v<A::extents_type, extents<size_t, 2, dynamic_extent>>);
+    static_assert(is_same_v<A::layout_type, layout_right>);
+    static_assert(is_same_v<A::container_type, vector<int>>);
+    static_assert(is_same_v<A::mapping_type, layout_right::mapping<extents<size_t, 2, dynamic_extent>>>);
+    static_assert(is_same_v<A::mdspan_type, mdspan<int, extents<size_t, 2, dynamic_extent>>>);
+    static_assert(is_same_v<A::const_mdspan_type, mdspan<const int, extents<size_t, 2, dynamic_extent>>>);
+    static_assert(A::rank() == 2);
+    static_assert(A::rank_dynamic() == 1);
+    static_assert(A::static_extent(0) == 2);
+    static_assert(A::is_always_exhaustive());
+}
+
+TEST(mdarray_tests, ctors) {
+    mdarray<double, extents<size_t, 3, 4>> a;
+    EXPECT_EQ(a.container().size(), 12u);
+    EXPECT_EQ(a.size(), 12u);
+
+    mdarray<double, dextents<size_t, 2>> b(3, 5);
+    EXPECT_EQ(b.extent(0), 3u);
+    EXPECT_EQ(b.extent(1), 5u);
+    EXPECT_EQ(b.container().size(), 15u);
+
+    mdarray<double, dextents<size_t, 2>, layout_left> c(dextents<size_t, 2>{2, 7});
+    EXPECT_EQ(c.stride(1), 2u);
+    EXPECT_EQ(c.container().size(), 14u);
+
+    using E = extents<size_t, 2, 3>;
+    const layout_stride::mapping<E> padded{E{}, array<size_t, 2>{4, 1}};
+    mdarray<int, E, layout_stride> d(padded);
+    EXPECT_EQ(d.container().size(), 7u);
+    EXPECT_FALSE(d.is_exhaustive());
+
+    mdarray<int, E> e(layout_right::mapping<E>{}, vector<int>{0, 1, 2, 3, 4, 5});
+    EXPECT_EQ(e(1, 2), 5);
+    const auto extracted = move(e).extract_container();
+    EXPECT_EQ(extracted.size(), 6u);
+}
+
+TEST(mdarray_tests, access) {
+    mdarray<int, dextents<size_t, 2>> a(2, 3);
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            a(i, j) = static_cast<int>(10 * i + j);
+        }
+    }
+
+    EXPECT_EQ(a.data()[4], 11);
+    EXPECT_EQ((a[array<size_t, 2>{1, 2}]), 12);
+
+    const auto& ca = a;
+    EXPECT_EQ(ca(0, 1), 1);
+
+    mdspan<int, dextents<size_t, 2>> view = a;
+    EXPECT_EQ(view.data(), a.data());
+    view(0, 0) = 42;
+    EXPECT_EQ(a(0, 0), 42);
+
+    mdspan<const int, dextents<size_t, 2>> const_view = ca.to_mdspan();
+    EXPECT_EQ(const_view(1, 0), 10);
+}
@@ -0,0 +1,99 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "numa.h"
+#include <atomic>
+
+using namespace std;
+
+TEST(numa_tests, topology) {
+    const auto detected = numa_topology::detect();
+    EXPECT_GE(detected.node_count(), 1u);
+    for (size_t node = 0; node < detected.node_count(); ++node) {
+        EXPECT_FALSE(detected.cpus(node).empty());
+    }
+
+    const numa_topology manual{{{0, 1}, {2}}};
+    EXPECT_EQ(manual.node_count(), 2u);
+    EXPECT_EQ(manual.cpus(1), vector<size_t>{2});
+
+    work_stealing_pool pool(manual, false);
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.node_count(), 2u);
+    EXPECT_EQ(pool.node_of(0), 0u);
+    EXPECT_EQ(pool.node_of(2), 1u);
+    EXPECT_EQ(pool.workers_on(0), (vector<size_t>{0, 1}));
+}
+
+TEST(numa_tests, run_on_node) {
+    work_stealing_pool pool(numa_topology{{{0}, {0}, {0}}}, false);
+    atomic<int> wrong{0};
+    task_group group(pool);
+    for (int i = 0; i < 300; ++i) {
+        const size_t node = static_cast<size_t>(i % 3);
+        group.run_on_node(node, [&, node] {
+            if (pool.node_of(pool.current_worker()) != node) {
+                ++wrong;
+            }
+        });
+    }
+    group.wait();
+    EXPECT_EQ(wrong.load(), 0);
+}
+
+TEST(numa_tests, partition) {
+    using E = extents<size_t, 10, 4>;
+    const auto right = make_numa_partition(layout_right::mapping<E>{}, 3);
+    EXPECT_EQ(right.dimension, 0u);
+    EXPECT_EQ(right.bounds, (vector<size_t>{0, 3, 6, 10}));
+    EXPECT_EQ(right.node_count(), 3u);
+
+    const auto left = make_numa_partition(layout_left::mapping<E>{}, 2);
+    EXPECT_EQ(left.dimension, 1u);
+    EXPECT_EQ(left.bounds, (vector<size_t>{0, 2, 4}));
+}
+
+TEST(numa_tests, mdarray) {
+    work_stealing_pool pool(numa_topology{{{0}, {0}}}, false);
+    auto a = make_numa_mdarray<double>(pool, dextents<size_t, 2>{7, 5});
+    EXPECT_EQ(a.container().size(), 35u);
+    EXPECT_EQ(a.container().element_bounds(), (vector<size_t>{0, 15, 35}));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a.data()) % 4096, 0u);
+    for (const double x : a.container()) {
+        EXPECT_EQ(x, 0.0);
+    }
+
+    auto b = make_numa_mdarray<float, layout_left>(pool, dextents<size_t, 2>{4, 6});
+    EXPECT_EQ(b.container().element_bounds(), (vector<size_t>{0, 12, 24}));
+
+    auto moved = move(a);
+    EXPECT_EQ(moved.container().size(), 35u);
+}
+
+TEST(numa_tests, parallel_for_tiles) {
+    work_stealing_pool pool(numa_topology{{{0}, {0}}}, false);
+    auto a = make_numa_mdarray<int>(pool, dextents<size_t, 2>{40, 9});
+    const auto partition = make_numa_partition(a.mapping(), pool.node_count());
+    auto view = a.to_mdspan();
+    atomic<int> misplaced{0};
+
+    parallel_for_tiles(pool, a.extents(), array<size_t, 2>{3, 4},
+        [&](const array<size_t, 2>& lo, const array<size_t, 2>& hi) {
+            const size_t node = pool.node_of(pool.current_worker());
+            if (lo[0] < partition.bounds[node] || hi[0] > partition.bounds[node + 1]) {
+                ++misplaced;
+            }
+            for (size_t i = lo[0]; i < hi[0]; ++i) {
+                for (size_t j = lo[1]; j < hi[1]; ++j) {
+                    view(i, j) += 1;
+                }
+            }
+        },
+        partition);
+
+    EXPECT_EQ(misplaced.load(), 0);
+    for (const int x : a.container()) {
+        EXPECT_EQ(x, 1);
+    }
+}
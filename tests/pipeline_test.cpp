@@ -0,0 +1,121 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "pipeline.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+using E = dextents<size_t, 2>;
+
+TEST(pipeline_tests, serial) {
+    vector<int> data(6 * 7);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i);
+    }
+    mdspan<int, E> m(data.data(), 6, 7);
+
+    const long long sum_sq_even = pipeline(m) | mdpipe::filter([](int v) { return v % 2 == 0; })
+                                | mdpipe::map([](int v) { return static_cast<long long>(v) * v; })
+                                | mdpipe::reduce(0LL);
+    long long expected = 0;
+    for (const int v : data) {
+        if (v % 2 == 0) {
+            expected += static_cast<long long>(v) * v;
+        }
+    }
+    EXPECT_EQ(sum_sq_even, expected);
+
+    // Values are visited once each, in memory order.
+    vector<int> seen;
+    pipeline(mdspan<int, E, layout_left>(data.data(), 7, 6)) | mdpipe::for_each([&](int v) { seen.push_back(v); });
+    EXPECT_EQ(seen, data);
+
+    const double max_half = pipeline(m) | mdpipe::map([](int v) { return v / 2.0; })
+                          | mdpipe::reduce(-1.0, [](double a, double b) { return (max)(a, b); });
+    EXPECT_EQ(max_half, 20.5);
+
+    // Nothing passes the filter.
+    EXPECT_EQ(pipeline(m) | mdpipe::filter([](int) { return false; }) | mdpipe::reduce(7), 7);
+}
+
+TEST(pipeline_tests, strided) {
+    // Every other column of a padded matrix.
+    vector<double> data(5 * 10);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<double>(i);
+    }
+    const layout_stride::mapping<E> map{E{5, 4}, array<size_t, 2>{10, 2}};
+    mdspan<double, E, layout_stride> m(data.data(), map);
+
+    double expected = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            expected += m(i, j);
+        }
+    }
+    EXPECT_EQ(pipeline(m) | mdpipe::reduce(0.0), expected);
+
+    // The outer dimension is the one with the largest stride, here dimension 1.
+    const layout_stride::mapping<E> transposed{E{4, 5}, array<size_t, 2>{2, 10}};
+    vector<double> seen;
+    pipeline(mdspan<double, E, layout_stride>(data.data(), transposed))
+        | mdpipe::for_each([&](double v) { seen.push_back(v); });
+    ASSERT_EQ(seen.size(), 20u);
+    EXPECT_EQ(seen[0], 0.0);
+    EXPECT_EQ(seen[1], 2.0);
+    EXPECT_EQ(seen[4], 10.0);
+}
+
+TEST(pipeline_tests, parallel) {
+    work_stealing_pool pool(4);
+    constexpr size_t rows = 301;
+    constexpr size_t cols = 17;
+    vector<int> data(rows * cols);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i % 1000);
+    }
+    mdspan<const int, E> m(data.data(), rows, cols);
+
+    long long expected = 0;
+    size_t expected_count = 0;
+    for (const int v : data) {
+        if (v > 500) {
+            expected += v * 3;
+            ++expected_count;
+        }
+    }
+
+    for (size_t grain : {size_t{0}, size_t{1}, size_t{7}, size_t{1000}}) {
+        const auto total = pipeline(pool, m, grain) | mdpipe::filter([](int v) { return v > 500; })
+                         | mdpipe::map([](int v) { return v * 3; }) | mdpipe::reduce(0LL);
+        EXPECT_EQ(total, expected) << grain;
+    }
+
+    atomic<size_t> count{0};
+    pipeline(pool, m) | mdpipe::filter([](int v) { return v > 500; }) | mdpipe::for_each([&](int) { ++count; });
+    EXPECT_EQ(count.load(), expected_count);
+
+    const auto product = pipeline(pool, m) | mdpipe::map([](int) { return 1.0; })
+                       | mdpipe::reduce(2.0, multiplies<>{});
+    EXPECT_EQ(product, 2.0);
+}
+
+TEST(pipeline_tests, parallel_uneven_blocks) {
+    // Extents that are not multiples of the grain leave a short last block.
+    work_stealing_pool pool(4);
+    for (const size_t n : {size_t{10}, size_t{1003}}) {
+        vector<long long> data(n);
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = static_cast<long long>(i + 1);
+        }
+        mdspan<const long long, dextents<size_t, 1>> m(data.data(), n);
+        const auto expected = static_cast<long long>(n * (n + 1) / 2);
+        for (int repeat = 0; repeat < 50; ++repeat) {
+            EXPECT_EQ(pipeline(pool, m, 4) | mdpipe::reduce(0LL), expected) << n;
+        }
+    }
+}
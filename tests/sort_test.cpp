@@ -0,0 +1,142 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "sort.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+using E2 = dextents<size_t, 2>;
+
+namespace {
+    vector<int> sample(const size_t size, const int seed) {
+        vector<int> result(size);
+        unsigned state = static_cast<unsigned>(seed);
+        for (auto& value : result) {
+            state = state * 1103515245u + 12345u;
+            value = static_cast<int>((state >> 16) % 50);
+        }
+        return result;
+    }
+} // namespace
+
+TEST(sort_tests, sort_along_each_axis) {
+    const size_t rows = 37, cols = 23;
+    const auto original = sample(rows * cols, 1);
+    for (size_t axis = 0; axis < 2; ++axis) {
+        for (const bool parallel : {false, true}) {
+            vector<int> data = original;
+            mdspan<int, E2> m(data.data(), rows, cols);
+            if (parallel) {
+                work_stealing_pool pool(4);
+                sort_along(pool, m, axis);
+            } else {
+                sort_along(m, axis);
+            }
+
+            const size_t lines = axis == 0 ? cols : rows;
+            const size_t length = axis == 0 ? rows : cols;
+            for (size_t line = 0; line < lines; ++line) {
+                vector<int> expected(length);
+                for (size_t i = 0; i < length; ++i) {
+                    expected[i] = axis == 0 ? original[i * cols + line] : original[line * cols + i];
+                }
+                sort(expected.begin(), expected.end());
+                for (size_t i = 0; i < length; ++i) {
+                    EXPECT_EQ(axis == 0 ? m(i, line) : m(line, i), expected[i]) << "axis " << axis;
+                }
+            }
+        }
+    }
+}
+
+TEST(sort_tests, argsort_is_stable) {
+    const vector<int> data{3, 1, 3, 0, 1, 3};
+    // Two lines along dimension 1 of a layout_left span, so the axis is not unit-stride.
+    mdspan<const int, E2, layout_left> m(data.data(), 2, 3);
+    vector<int> out(6);
+    mdspan<int, E2> idx(out.data(), 2, 3);
+    argsort(m, idx, 1);
+
+    // Line 0 is {3, 3, 1}; line 1 is {1, 0, 3}.
+    EXPECT_EQ(idx(0, 0), 2);
+    EXPECT_EQ(idx(0, 1), 0);
+    EXPECT_EQ(idx(0, 2), 1);
+    EXPECT_EQ(idx(1, 0), 1);
+    EXPECT_EQ(idx(1, 1), 0);
+    EXPECT_EQ(idx(1, 2), 2);
+}
+
+TEST(sort_tests, nth_element_along) {
+    auto data = sample(5 * 40, 7);
+    const auto original = data;
+    mdspan<int, E2> m(data.data(), 5, 40);
+    work_stealing_pool pool(2);
+    nth_element_along(pool, m, 1, 10);
+
+    for (size_t row = 0; row < 5; ++row) {
+        vector<int> expected(original.begin() + row * 40, original.begin() + (row + 1) * 40);
+        nth_element(expected.begin(), expected.begin() + 10, expected.end());
+        EXPECT_EQ(m(row, 10), expected[10]);
+        for (size_t i = 0; i < 40; ++i) {
+            EXPECT_EQ(m(row, i) < m(row, 10), i < 10 && m(row, i) != m(row, 10)) << row << ' ' << i;
+        }
+    }
+}
+
+TEST(sort_tests, top_k_rows_and_columns) {
+    const size_t rows = 50, cols = 30, k = 4;
+    const auto data = sample(rows * cols, 3);
+    mdspan<const int, E2> m(data.data(), rows, cols);
+    work_stealing_pool pool(3);
+
+    // Per row.
+    vector<int> row_values(rows * k);
+    vector<size_t> row_indices(rows * k);
+    top_k(pool, m, mdspan<int, E2>(row_values.data(), rows, k), mdspan<size_t, E2>(row_indices.data(), rows, k), 1);
+    for (size_t row = 0; row < rows; ++row) {
+        vector<int> line(data.begin() + row * cols, data.begin() + (row + 1) * cols);
+        sort(line.begin(), line.end(), greater<>{});
+        for (size_t i = 0; i < k; ++i) {
+            EXPECT_EQ(row_values[row * k + i], line[i]);
+            EXPECT_EQ(m(row, row_indices[row * k + i]), line[i]);
+        }
+    }
+
+    // Per column, smallest first.
+    vector<int> col_values(k * cols);
+    vector<size_t> col_indices(k * cols);
+    mdspan<int, E2> values(col_values.data(), k, cols);
+    mdspan<size_t, E2> indices(col_indices.data(), k, cols);
+    top_k(m, values, indices, 0, less<>{});
+    for (size_t col = 0; col < cols; ++col) {
+        vector<int> line(rows);
+        for (size_t row = 0; row < rows; ++row) {
+            line[row] = m(row, col);
+        }
+        sort(line.begin(), line.end());
+        for (size_t i = 0; i < k; ++i) {
+            EXPECT_EQ(values(i, col), line[i]);
+            EXPECT_EQ(m(indices(i, col), col), line[i]);
+            if (i > 0 && values(i, col) == values(i - 1, col)) {
+                EXPECT_LT(indices(i - 1, col), indices(i, col));
+            }
+        }
+    }
+}
+
+TEST(sort_tests, zero_extents) {
+    // Nothing is touched, so a null data handle is fine.
+    work_stealing_pool pool(2);
+    for (const size_t rows : {size_t{0}, size_t{3}}) {
+        mdspan<double, E2> m(nullptr, rows, 3 - rows);
+        sort_along(m, 1);
+        sort_along(pool, m, 0);
+        nth_element_along(m, 1, 0);
+        mdspan<size_t, E2> idx(nullptr, rows, 3 - rows);
+        argsort(m, idx, 1);
+        top_k(m, mdspan<double, E2>(nullptr, rows, 0), mdspan<size_t, E2>(nullptr, rows, 0), 1);
+    }
+}
@@ -0,0 +1,152 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "sparse.h"
+#include <vector>
+
+using namespace std;
+
+// 4 x 5
+// [ 1 0 2 0 0 ]
+// [ 0 0 0 0 0 ]
+// [ 0 3 0 4 5 ]
+// [ 6 0 0 0 7 ]
+struct sparse_fixture {
+    vector<size_t> offsets{0, 2, 2, 5, 7};
+    vector<size_t> columns{0, 2, 1, 3, 4, 0, 4};
+    vector<double> values{1, 2, 3, 4, 5, 6, 7};
+
+    csr_matrix_view<double> csr() {
+        return {dextents<size_t, 2>{4, 5}, offsets, columns, values};
+    }
+
+    static double dense(size_t i, size_t j) {
+        static constexpr double d[4][5] = {{1, 0, 2, 0, 0}, {0, 0, 0, 0, 0}, {0, 3, 0, 4, 5}, {6, 0, 0, 0, 7}};
+        return d[i][j];
+    }
+};
+
+TEST(sparse_tests, csr_view) {
+    sparse_fixture f;
+    const auto a = f.csr();
+    EXPECT_EQ(a.extent(0), 4u);
+    EXPECT_EQ(a.extent(1), 5u);
+    EXPECT_EQ(a.nnz(), 7u);
+    EXPECT_EQ(a.row(1).columns.size(), 0u);
+    EXPECT_EQ(a.row(2).columns[1], 3u);
+    EXPECT_EQ(a.row(2).values[1], 4.0);
+
+    // The stored values are an ordinary mdspan.
+    auto vals = a.values();
+    static_assert(decltype(vals)::rank() == 1);
+    EXPECT_EQ(vals.extent(0), 7u);
+    for (size_t k = 0; k < vals.extent(0); ++k) {
+        vals(k) *= 2;
+    }
+    EXPECT_EQ(f.values[6], 14.0);
+
+    size_t count = 0;
+    for_each_nonzero(a, [&](size_t i, size_t j, double v) {
+        EXPECT_EQ(v, 2 * sparse_fixture::dense(i, j));
+        ++count;
+    });
+    EXPECT_EQ(count, 7u);
+}
+
+TEST(sparse_tests, coo_to_csr) {
+    // Same matrix, shuffled, with 32-bit indices.
+    vector<uint32_t> rows{3, 0, 2, 2, 0, 3, 2};
+    vector<uint32_t> cols{0, 0, 3, 1, 2, 4, 4};
+    vector<float> vals{6, 1, 4, 3, 2, 7, 5};
+    const coo_matrix_view<const float, uint32_t> coo(dextents<uint32_t, 2>{4, 5}, rows, cols, vals);
+
+    size_t count = 0;
+    for_each_nonzero(coo, [&](uint32_t i, uint32_t j, float v) {
+        EXPECT_EQ(v, sparse_fixture::dense(i, j));
+        ++count;
+    });
+    EXPECT_EQ(count, 7u);
+
+    vector<uint32_t> offsets(5);
+    vector<uint32_t> out_cols(7);
+    vector<float> out_vals(7);
+    const auto csr = coo_to_csr(coo, span<uint32_t>{offsets}, span<uint32_t>{out_cols}, span<float>{out_vals});
+    EXPECT_EQ(offsets, (vector<uint32_t>{0, 2, 2, 5, 7}));
+    // Stable within a row.
+    EXPECT_EQ(out_cols, (vector<uint32_t>{0, 2, 3, 1, 4, 0, 4}));
+    EXPECT_EQ(out_vals, (vector<float>{1, 2, 4, 3, 5, 6, 7}));
+    EXPECT_EQ(csr.nnz(), 7u);
+}
+
+TEST(sparse_tests, spmv) {
+    sparse_fixture f;
+    vector<double> x{1, 2, 3, 4, 5};
+    vector<double> expected{7, 0, 47, 41};
+
+    vector<double> y(4, -1);
+    spmv(f.csr(), mdspan<const double, dextents<size_t, 1>>(x.data(), 5), mdspan<double, dextents<size_t, 1>>(y.data(), 4));
+    EXPECT_EQ(y, expected);
+
+    vector<size_t> rows{0, 0, 2, 2, 2, 3, 3};
+    const coo_matrix_view<double> coo(dextents<size_t, 2>{4, 5}, rows, f.columns, f.values);
+    fill(y.begin(), y.end(), -1);
+    spmv(coo, mdspan<double, dextents<size_t, 1>>(x.data(), 5), mdspan<double, dextents<size_t, 1>>(y.data(), 4));
+    EXPECT_EQ(y, expected);
+
+    work_stealing_pool pool(3);
+    fill(y.begin(), y.end(), -1);
+    spmv(pool, f.csr(), mdspan<double, dextents<size_t, 1>>(x.data(), 5), mdspan<double, dextents<size_t, 1>>(y.data(), 4), 1);
+    EXPECT_EQ(y, expected);
+}
+
+template <class BLayout, class CLayout>
+void check_spmm(work_stealing_pool* pool) {
+    sparse_fixture f;
+    constexpr size_t n = 3;
+    using E = dextents<size_t, 2>;
+    vector<double> b_data(5 * n);
+    mdspan<double, E, BLayout> b(b_data.data(), 5, n);
+    for (size_t k = 0; k < 5; ++k) {
+        for (size_t j = 0; j < n; ++j) {
+            b(k, j) = static_cast<double>(k * n + j + 1);
+        }
+    }
+
+    vector<double> c_data(4 * n, -1);
+    mdspan<double, E, CLayout> c(c_data.data(), 4, n);
+    if (pool) {
+        spmm(*pool, f.csr(), b, c, 1);
+    } else {
+        spmm(f.csr(), b, c);
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double expected = 0;
+            for (size_t k = 0; k < 5; ++k) {
+                expected += sparse_fixture::dense(i, k) * b(k, j);
+            }
+            EXPECT_EQ(c(i, j), expected) << i << ", " << j;
+        }
+    }
+}
+
+TEST(sparse_tests, spmm) {
+    check_spmm<layout_right, layout_right>(nullptr);
+    check_spmm<layout_left, layout_left>(nullptr);
+    check_spmm<layout_right, layout_left>(nullptr);
+    check_spmm<layout_left, layout_right>(nullptr);
+
+    work_stealing_pool pool(2);
+    check_spmm<layout_right, layout_right>(&pool);
+    check_spmm<layout_left, layout_left>(&pool);
+
+    sparse_fixture f;
+    vector<size_t> rows{0, 0, 2, 2, 2, 3, 3};
+    const coo_matrix_view<double> coo(dextents<size_t, 2>{4, 5}, rows, f.columns, f.values);
+    vector<double> b(5 * 2, 1.0);
+    vector<double> c(4 * 2, -1);
+    spmm(coo, mdspan<double, dextents<size_t, 2>>(b.data(), 5, 2), mdspan<double, dextents<size_t, 2>>(c.data(), 4, 2));
+    EXPECT_EQ(c, (vector<double>{3, 3, 0, 0, 12, 12, 13, 13}));
+}
@@ -0,0 +1,209 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "stencil.h"
+#include <vector>
+
+using namespace std;
+
+template <class Shape, class InSpan, class OutSpan, class Weight>
+void naive_stencil_2d(const InSpan& in, const OutSpan& out, Shape, const array<Weight, Shape::size()>& w) {
+    const size_t r = Shape::radius();
+    for (size_t i = r; i + r < in.extent(0); ++i) {
+        for (size_t j = r; j + r < in.extent(1); ++j) {
+            double sum = 0;
+            for (size_t p = 0; p < Shape::size(); ++p) {
+                sum += w[p] * in(i + Shape::offsets[p][0], j + Shape::offsets[p][1]);
+            }
+            out(i, j) = sum;
+        }
+    }
+}
+
+template <class Shape, class InSpan, class OutSpan, class Weight>
+void naive_stencil_3d(const InSpan& in, const OutSpan& out, Shape, const array<Weight, Shape::size()>& w) {
+    const size_t r = Shape::radius();
+    for (size_t i = r; i + r < in.extent(0); ++i) {
+        for (size_t j = r; j + r < in.extent(1); ++j) {
+            for (size_t k = r; k + r < in.extent(2); ++k) {
+                double sum = 0;
+                for (size_t p = 0; p < Shape::size(); ++p) {
+                    sum += w[p] * in(i + Shape::offsets[p][0], j + Shape::offsets[p][1], k + Shape::offsets[p][2]);
+                }
+                out(i, j, k) = sum;
+            }
+        }
+    }
+}
+
+vector<double> iota_data(size_t n) {
+    vector<double> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<double>((i * 7) % 13);
+    }
+    return v;
+}
+
+TEST(stencil_tests, shapes) {
+    using S5 = stencil_star<2, 1>;
+    static_assert(S5::size() == 5);
+    static_assert(S5::radius() == 1);
+    static_assert(S5::offsets[0] == array<ptrdiff_t, 2>{0, 0});
+    static_assert(S5::offsets[1] == array<ptrdiff_t, 2>{-1, 0});
+    static_assert(S5::offsets[4] == array<ptrdiff_t, 2>{0, 1});
+
+    static_assert(stencil_star<3, 2>::size() == 13);
+
+    using S27 = stencil_box<3, 1>;
+    static_assert(S27::size() == 27);
+    static_assert(S27::offsets[0] == array<ptrdiff_t, 3>{0, 0, 0});
+    for (size_t p = 1; p < S27::size(); ++p) {
+        EXPECT_NE(S27::offsets[p], S27::offsets[0]);
+    }
+}
+
+TEST(stencil_tests, apply_layouts) {
+    using S = stencil_star<2, 1>;
+    constexpr array<double, S::size()> w{4, -1, -1, -1, -2};
+    constexpr size_t rows = 9;
+    constexpr size_t cols = 11;
+    const stencil_blocking blocking{4, 3, 1};
+
+    auto in_data = iota_data(rows * cols);
+    vector<double> expected(rows * cols, -1);
+    vector<double> actual(rows * cols, -1);
+
+    using E = dextents<size_t, 2>;
+    naive_stencil_2d(mdspan<double, E>(in_data.data(), rows, cols), mdspan<double, E>(expected.data(), rows, cols), S{}, w);
+
+    stencil_apply(mdspan<const double, E>(in_data.data(), rows, cols), mdspan<double, E>(actual.data(), rows, cols),
+        S{}, w, blocking);
+    EXPECT_EQ(actual, expected);
+
+    // layout_left walks the same logical grid column by column.
+    mdspan<double, E, layout_left> in_left(in_data.data(), cols, rows);
+    vector<double> expected_left(rows * cols, -1);
+    vector<double> actual_left(rows * cols, -1);
+    naive_stencil_2d(in_left, mdspan<double, E, layout_left>(expected_left.data(), cols, rows), S{}, w);
+    stencil_apply(in_left, mdspan<double, E, layout_left>(actual_left.data(), cols, rows), S{}, w, blocking);
+    EXPECT_EQ(actual_left, expected_left);
+
+    // Padded rows.
+    constexpr size_t pitch = 16;
+    vector<double> in_padded(rows * pitch, 99);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            in_padded[i * pitch + j] = in_data[i * cols + j];
+        }
+    }
+    const layout_stride::mapping<E> padded{E{rows, cols}, array<size_t, 2>{pitch, 1}};
+    vector<double> actual_padded(rows * pitch, -1);
+    stencil_apply(mdspan<double, E, layout_stride>(in_padded.data(), padded),
+        mdspan<double, E, layout_stride>(actual_padded.data(), padded), S{}, w, blocking);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            EXPECT_EQ(actual_padded[i * pitch + j], expected[i * cols + j]);
+        }
+    }
+}
+
+TEST(stencil_tests, apply_box_3d) {
+    using S = stencil_box<3, 1>;
+    array<double, S::size()> w;
+    for (size_t p = 0; p < S::size(); ++p) {
+        w[p] = static_cast<double>(p % 5) - 2;
+    }
+
+    using E = extents<size_t, 6, dynamic_extent, 7>;
+    const E e{5};
+    auto in_data = iota_data(6 * 5 * 7);
+    vector<double> expected(in_data.size(), 0);
+    vector<double> actual(in_data.size(), 0);
+
+    naive_stencil_3d(mdspan<double, E>(in_data.data(), e), mdspan<double, E>(expected.data(), e), S{}, w);
+    stencil_apply(mdspan<double, E>(in_data.data(), e), mdspan<double, E>(actual.data(), e), S{}, w,
+        stencil_blocking{2, 2, 1});
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(stencil_tests, iterate) {
+    using S = stencil_star<2, 1>;
+    constexpr array<double, S::size()> w{0.5, 0.125, 0.125, 0.125, 0.125};
+    constexpr size_t rows = 13;
+    constexpr size_t cols = 10;
+    constexpr size_t steps = 7;
+    using E = dextents<size_t, 2>;
+
+    auto reference = iota_data(rows * cols);
+    auto scratch = reference;
+    for (size_t step = 0; step < steps; ++step) {
+        naive_stencil_2d(mdspan<double, E>(reference.data(), rows, cols), mdspan<double, E>(scratch.data(), rows, cols),
+            S{}, w);
+        swap(reference, scratch);
+    }
+
+    for (size_t fused : {size_t{1}, size_t{3}, size_t{4}}) {
+        auto grid = iota_data(rows * cols);
+        vector<double> buffer(rows * cols);
+        stencil_iterate(mdspan<double, E>(grid.data(), rows, cols), mdspan<double, E>(buffer.data(), rows, cols), S{},
+            w, steps, stencil_blocking{3, 4, fused});
+        for (size_t i = 0; i < grid.size(); ++i) {
+            EXPECT_DOUBLE_EQ(grid[i], reference[i]) << "fused=" << fused << " i=" << i;
+        }
+    }
+}
+
+TEST(stencil_tests, iterate_layout_left_3d) {
+    using S = stencil_star<3, 1>;
+    constexpr array<double, S::size()> w{0.25, 0.125, 0.125, 0.125, 0.125, 0.125, 0.125};
+    using E = dextents<size_t, 3>;
+    const E e{6, 7, 8};
+    constexpr size_t steps = 5;
+
+    auto reference = iota_data(6 * 7 * 8);
+    auto scratch = reference;
+    for (size_t step = 0; step < steps; ++step) {
+        naive_stencil_3d(mdspan<double, E, layout_left>(reference.data(), e),
+            mdspan<double, E, layout_left>(scratch.data(), e), S{}, w);
+        swap(reference, scratch);
+    }
+
+    auto grid = iota_data(6 * 7 * 8);
+    vector<double> buffer(grid.size());
+    stencil_iterate(mdspan<double, E, layout_left>(grid.data(), e), mdspan<double, E, layout_left>(buffer.data(), e),
+        S{}, w, steps, stencil_blocking{4, 2, 2});
+    for (size_t i = 0; i < grid.size(); ++i) {
+        EXPECT_DOUBLE_EQ(grid[i], reference[i]) << i;
+    }
+}
+
+TEST(stencil_tests, parallel) {
+    work_stealing_pool pool(4);
+    using S = stencil_box<2, 1>;
+    array<double, S::size()> w;
+    for (size_t p = 0; p < S::size(); ++p) {
+        w[p] = 1.0 / S::size();
+    }
+
+    constexpr size_t rows = 41;
+    constexpr size_t cols = 29;
+    using E = dextents<size_t, 2>;
+    auto in_data = iota_data(rows * cols);
+    vector<double> expected(rows * cols, 0);
+    vector<double> actual(rows * cols, 0);
+
+    stencil_apply(mdspan<double, E>(in_data.data(), rows, cols), mdspan<double, E>(expected.data(), rows, cols), S{}, w);
+    stencil_apply(pool, mdspan<double, E>(in_data.data(), rows, cols), mdspan<double, E>(actual.data(), rows, cols), S{},
+        w, stencil_blocking{8, 4, 1});
+    EXPECT_EQ(actual, expected);
+
+    auto serial = in_data;
+    auto parallel = in_data;
+    vector<double> scratch(rows * cols);
+    stencil_iterate(mdspan<double, E>(serial.data(), rows, cols), mdspan<double, E>(scratch.data(), rows, cols), S{}, w,
+        9, stencil_blocking{8, 4, 3});
+    stencil_iterate(pool, mdspan<double, E>(parallel.data(), rows, cols), mdspan<double, E>(scratch.data(), rows, cols),
+        S{}, w, 9, stencil_blocking{8, 4, 3});
+    EXPECT_EQ(parallel, serial);
+}
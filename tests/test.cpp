@@ -225,6 +225,11 @@ TEST(extent_tests, ctor_array) {
     extents<size_t, dynamic_extent, dynamic_extent> e6(to_array<int>({ 5, 7 }));
     EXPECT_EQ(e6.extent(0), 5u);
     EXPECT_EQ(e6.extent(1), 7u);
+
+    // full rank, mixed static and dynamic
+    extents<size_t, 2, dynamic_extent, 3, dynamic_extent> e7(to_array<size_t>({ 2, 5, 3, 7 }));
+    EXPECT_EQ(e7.extent(1), 5u);
+    EXPECT_EQ(e7.extent(3), 7u);
 }
 
 TEST(extent_tests, ctor_span) {
@@ -932,3 +937,343 @@ TEST(mdspan_tests, observers)
     static_assert(mds[array{ 0, 1 }] == 3);
     static_assert(mds[array{ 1, 1 }] == 4);
 }
+
+TEST(mdspan_tests, ctor_other)
+{
+    using S = extents<size_t, 2, 3>;
+    using D = dextents<size_t, 2>;
+
+    // Adding const, dropping static extents and generalizing the layout are implicit.
+    static_assert(is_convertible_v<mdspan<int, S>, mdspan<const int, S>>);
+    static_assert(is_convertible_v<mdspan<int, S>, mdspan<int, D>>);
+    static_assert(is_convertible_v<mdspan<int, S>, mdspan<const int, D, layout_stride>>);
+    static_assert(is_convertible_v<mdspan<int, S, layout_left>, mdspan<int, D, layout_stride>>);
+
+    // Removing const, or layouts that do not convert, are not constructible.
+    static_assert(!is_constructible_v<mdspan<int, S>, mdspan<const int, S>>);
+    static_assert(!is_constructible_v<mdspan<int, S>, mdspan<int, S, layout_left>>);
+    static_assert(!is_constructible_v<mdspan<int, extents<size_t, 2, 4>>, mdspan<int, S>>);
+
+    // Recovering static extents or a layout_right mapping from a layout_stride one must be explicit.
+    static_assert(is_constructible_v<mdspan<int, S>, mdspan<int, D>>);
+    static_assert(!is_convertible_v<mdspan<int, D>, mdspan<int, S>>);
+    static_assert(is_constructible_v<mdspan<int, D>, mdspan<int, D, layout_stride>>);
+    static_assert(!is_convertible_v<mdspan<int, D, layout_stride>, mdspan<int, D>>);
+
+    int arr[6] = { 0, 1, 2, 3, 4, 5 };
+    constexpr auto strided = [](const mdspan<const int, D, layout_stride> m) { return m(1, 2); };
+    const mdspan<int, S> mds(arr);
+    EXPECT_EQ(strided(mds), 5);
+
+    const mdspan<const int, D> dyn = mds;
+    EXPECT_EQ(dyn.data(), arr);
+    EXPECT_EQ(dyn.extent(0), 2u);
+    EXPECT_EQ(dyn.extent(1), 3u);
+
+    const mdspan<int, S> back(mdspan<int, D>(arr, 2, 3));
+    EXPECT_EQ(back(1, 0), 3);
+}
+
+template <class Mapping>
+void TestPackedMapping(const Mapping& map) {
+    const size_t n = map.extents().extent(0);
+    EXPECT_EQ(map.required_span_size(), n * (n + 1) / 2);
+
+    vector<size_t> hits(map.required_span_size());
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            EXPECT_EQ(map(i, j), map(j, i));
+            EXPECT_LT(map(i, j), map.required_span_size());
+            if (i <= j) {
+                ++hits[map(i, j)];
+            }
+        }
+    }
+
+    // Every stored offset belongs to exactly one element of the triangle.
+    for (const auto hit : hits) {
+        EXPECT_EQ(hit, 1u);
+    }
+    EXPECT_EQ(map.is_unique(), n < 2);
+    EXPECT_TRUE(map.is_exhaustive());
+}
+
+TEST(layout_packed_tests, traits) {
+    static_assert(is_regular_trivial_nothrow_v<layout_packed_upper::mapping<extents<size_t, 3, 3>>>);
+    static_assert(is_regular_trivial_nothrow_v<layout_packed_lower::mapping<extents<size_t, dynamic_extent, dynamic_extent>>>);
+
+    using E = extents<int, 3, 3>;
+    static_assert(is_same_v<layout_packed_upper::mapping<E>::extents_type, E>);
+    static_assert(is_same_v<layout_packed_upper::mapping<E>::layout_type, layout_packed_upper>);
+    static_assert(is_same_v<layout_packed_lower::mapping<E>::layout_type, layout_packed_lower>);
+
+    static_assert(!layout_packed_upper::mapping<E>::is_always_unique());
+    static_assert(layout_packed_upper::mapping<E>::is_always_exhaustive());
+    static_assert(!layout_packed_lower::mapping<E>::is_always_strided());
+
+    static_assert(is_convertible_v<layout_packed_upper::mapping<E>, layout_packed_upper::mapping<dextents<int, 2>>>);
+    static_assert(!is_convertible_v<layout_packed_upper::mapping<dextents<int, 2>>, layout_packed_upper::mapping<E>>);
+    static_assert(!is_constructible_v<layout_packed_lower::mapping<E>, layout_packed_upper::mapping<E>>);
+}
+
+TEST(layout_packed_tests, indexing) {
+    // BLAS column-major packed order.
+    constexpr layout_packed_upper::mapping<extents<size_t, 3, 3>> upper{};
+    static_assert(upper.required_span_size() == 6);
+    static_assert(upper(0, 0) == 0);
+    static_assert(upper(0, 1) == 1);
+    static_assert(upper(1, 1) == 2);
+    static_assert(upper(0, 2) == 3);
+    static_assert(upper(2, 2) == 5);
+    static_assert(upper(2, 0) == 3);
+
+    constexpr layout_packed_lower::mapping<extents<size_t, 3, 3>> lower{};
+    static_assert(lower(0, 0) == 0);
+    static_assert(lower(1, 0) == 1);
+    static_assert(lower(2, 0) == 2);
+    static_assert(lower(1, 1) == 3);
+    static_assert(lower(2, 1) == 4);
+    static_assert(lower(2, 2) == 5);
+    static_assert(lower(0, 2) == 2);
+
+    for (size_t n : {0u, 1u, 2u, 5u, 8u}) {
+        TestPackedMapping(layout_packed_upper::mapping<dextents<size_t, 2>>{dextents<size_t, 2>{n, n}});
+        TestPackedMapping(layout_packed_lower::mapping<dextents<size_t, 2>>{dextents<size_t, 2>{n, n}});
+    }
+}
+
+TEST(layout_packed_tests, mdspan) {
+    // Symmetric 3x3 matrix in 6 elements.
+    double packed[6] = { 1, 2, 3, 4, 5, 6 };
+    mdspan<double, extents<size_t, 3, 3>, layout_packed_upper> sym(packed);
+    EXPECT_EQ(sym.mapping().required_span_size(), 6u);
+    EXPECT_FALSE(sym.is_unique());
+    EXPECT_TRUE(sym.is_exhaustive());
+    EXPECT_EQ(sym(1, 2), 5);
+    EXPECT_EQ(sym(2, 1), 5);
+
+    sym(2, 0) = 42;
+    EXPECT_EQ(sym(0, 2), 42);
+    EXPECT_EQ(packed[3], 42);
+
+    mdspan<double, dextents<size_t, 2>, layout_packed_lower> lower(packed, 3, 3);
+    EXPECT_EQ(lower(2, 1), packed[4]);
+}
+
+TEST(layout_permuted_tests, traits) {
+    using E = extents<size_t, 2, dynamic_extent, 4>;
+    using M = layout_permuted<layout_right, 2, 0, 1>::mapping<E>;
+    static_assert(is_same_v<M::base_mapping_type, layout_right::mapping<extents<size_t, dynamic_extent, 4, 2>>>);
+    static_assert(M::is_always_unique());
+    static_assert(M::is_always_exhaustive());
+    static_assert(M::is_always_strided());
+    static_assert(_Is_permutation_v<1, 2, 0>);
+    static_assert(!_Is_permutation_v<1, 1, 0>);
+    static_assert(!_Is_permutation_v<0, 3>);
+}
+
+TEST(layout_permuted_tests, mapping) {
+    // A (2, 3, 4) layout_right array viewed as (4, 2, 3).
+    constexpr layout_permuted<layout_right, 2, 0, 1>::mapping<extents<size_t, 4, 2, 3>> map{};
+    static_assert(map.required_span_size() == 24);
+    static_assert(map(0, 0, 0) == 0);
+    static_assert(map(1, 0, 0) == 1);
+    static_assert(map(0, 1, 0) == 12);
+    static_assert(map(0, 0, 1) == 4);
+    static_assert(map(3, 1, 2) == 23);
+    static_assert(map.stride(0) == 1 && map.stride(1) == 12 && map.stride(2) == 4);
+    static_assert(map.extents().extent(0) == 4 && map.extents().extent(2) == 3);
+}
+
+TEST(layout_permuted_tests, permute) {
+    vector<int> data(2 * 3 * 4);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i);
+    }
+    mdspan<int, extents<size_t, 2, dynamic_extent, 4>> m(data.data(), 3);
+
+    // Reversing layout_right is layout_left, keeping static extents.
+    const auto t = permute<2, 1, 0>(m);
+    static_assert(is_same_v<decltype(t), const mdspan<int, extents<size_t, 4, dynamic_extent, 2>, layout_left>>);
+    EXPECT_EQ(t.extent(1), 3u);
+    EXPECT_EQ(t(3, 2, 1), m(1, 2, 3));
+    EXPECT_EQ(t.data(), data.data());
+
+    const auto back = permute<2, 1, 0>(t);
+    static_assert(is_same_v<decltype(back), const decltype(m)>);
+
+    // Other permutations keep the base layout and its contiguity.
+    const auto s = permute<0, 2, 1>(m);
+    static_assert(is_same_v<decltype(s)::layout_type, layout_permuted<layout_right, 0, 2, 1>>);
+    static_assert(decltype(s)::is_always_exhaustive());
+    EXPECT_EQ(s.extent(1), 4u);
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            for (size_t k = 0; k < 3; ++k) {
+                EXPECT_EQ(s(i, j, k), m(i, k, j));
+            }
+        }
+    }
+    EXPECT_EQ(s.stride(1), 1u);
+
+    // Permutations compose, so undoing one returns the original layout.
+    const auto undone = permute<0, 2, 1>(s);
+    static_assert(is_same_v<decltype(undone), const decltype(m)>);
+    const auto reversed = permute<1, 2, 0>(s);
+    static_assert(is_same_v<decltype(reversed)::layout_type, layout_left>);
+    EXPECT_EQ(reversed(3, 2, 1), m(1, 2, 3));
+
+    static_assert(is_same_v<decltype(permute<0, 1, 2>(m)), decltype(m)>);
+}
+
+TEST(layout_broadcast_tests, mapping) {
+    using M = layout_broadcast<layout_right, 0>::mapping<extents<size_t, 3, 4>>;
+    static_assert(is_same_v<M::base_mapping_type, layout_right::mapping<extents<size_t, 4>>>);
+    static_assert(!M::is_always_unique());
+    static_assert(M::is_always_exhaustive());
+    static_assert(M::is_always_strided());
+
+    constexpr M map{};
+    static_assert(map.required_span_size() == 4);
+    static_assert(map(0, 3) == 3);
+    static_assert(map(2, 3) == 3);
+    static_assert(map.stride(0) == 0 && map.stride(1) == 1);
+    static_assert(!map.is_unique());
+    static_assert(map.is_exhaustive());
+
+    constexpr layout_broadcast<layout_right, 1>::mapping<extents<size_t, 3, 1>> single{};
+    static_assert(single.is_unique());
+    static_assert(single(2, 0) == 2);
+
+    // Broadcast along the middle of a rank-3 array.
+    constexpr layout_broadcast<layout_left, 1>::mapping<extents<size_t, 2, 5, 3>> middle{};
+    static_assert(middle.required_span_size() == 6);
+    static_assert(middle(1, 4, 2) == 5);
+    static_assert(middle.stride(0) == 1 && middle.stride(1) == 0 && middle.stride(2) == 2);
+}
+
+TEST(layout_broadcast_tests, broadcast) {
+    double bias[4] = {1, 2, 3, 4};
+    mdspan<double, dextents<size_t, 1>> b(bias, 4);
+
+    const auto rows = broadcast<0>(b, dextents<size_t, 2>{3, 4});
+    static_assert(is_same_v<decltype(rows)::layout_type, layout_broadcast<layout_right, 0>>);
+    EXPECT_EQ(rows.extent(0), 3u);
+    EXPECT_EQ(rows.mapping().required_span_size(), 4u);
+    EXPECT_FALSE(rows.is_unique());
+    EXPECT_EQ(rows(2, 1), 2);
+    EXPECT_EQ(&rows(0, 3), &rows(2, 3));
+
+    const auto cols = broadcast<1>(b, extents<size_t, 4, 5>{});
+    EXPECT_EQ(cols(3, 0), 4);
+    EXPECT_EQ(cols(3, 4), 4);
+    EXPECT_EQ(cols.stride(1), 0u);
+}
+
+TEST(reshape_tests, reshape) {
+    int data[24];
+    for (int i = 0; i < 24; ++i) {
+        data[i] = i;
+    }
+
+    mdspan<int, extents<size_t, 2, 3, 4>> m(data);
+    const auto flat = reshape(m, extents<size_t, 24>{});
+    static_assert(is_same_v<decltype(flat), const mdspan<int, extents<size_t, 24>>>);
+    EXPECT_EQ(flat.data(), data);
+    EXPECT_EQ(flat(13), m(1, 0, 1));
+
+    // An inferred extent is static when the source's are.
+    const auto grid = reshape<6, dynamic_extent>(m);
+    static_assert(is_same_v<decltype(grid)::extents_type, extents<size_t, 6, 4>>);
+    EXPECT_EQ(grid(5, 3), 23);
+
+    mdspan<int, dextents<size_t, 2>, layout_left> left(data, 4, 6);
+    const auto cube = reshape<2, dynamic_extent, 3>(left);
+    static_assert(is_same_v<decltype(cube), const mdspan<int, extents<size_t, 2, dynamic_extent, 3>, layout_left>>);
+    EXPECT_EQ(cube.extent(1), 4u);
+    EXPECT_EQ(cube(1, 2, 1), left(1, 3));
+
+    const auto back = reshape(cube, dextents<size_t, 2>{4, 6});
+    EXPECT_EQ(back(3, 5), 23);
+}
+
+TEST(extents_algebra_tests, static_shapes) {
+    using E = extents<size_t, 2, dynamic_extent, 4>;
+    static_assert(extents_static_size_v<extents<size_t, 2, 3, 4>> == 24);
+    static_assert(extents_static_size_v<E> == dynamic_extent);
+    static_assert(extents_static_size_v<extents<size_t>> == 1);
+
+    static_assert(is_same_v<extents_cat_t<E, extents<int, 5>, dextents<size_t, 1>>,
+        extents<size_t, 2, dynamic_extent, 4, 5, dynamic_extent>>);
+    static_assert(is_same_v<extents_drop_t<E, 0, 2>, extents<size_t, dynamic_extent>>);
+    static_assert(is_same_v<extents_insert_t<E, 1, 7>, extents<size_t, 2, 7, dynamic_extent, 4>>);
+    static_assert(is_same_v<extents_insert_t<E, 3, dynamic_extent>, extents<size_t, 2, dynamic_extent, 4, dynamic_extent>>);
+
+    static_assert(is_same_v<extents_broadcast_t<extents<size_t, 3, 1>, extents<size_t, 4>>, extents<size_t, 3, 4>>);
+    static_assert(is_same_v<extents_broadcast_t<dextents<size_t, 2>, extents<size_t, 1, 5>>,
+        extents<size_t, dynamic_extent, 5>>);
+    static_assert(is_same_v<extents_broadcast_t<extents<size_t, 1>, dextents<size_t, 1>>, dextents<size_t, 1>>);
+
+    static_assert(is_same_v<extents_merge_t<dextents<size_t, 3>, E>, E>);
+    static_assert(is_same_v<extents_merge_t<extents<size_t, dynamic_extent, 3>, extents<size_t, 6, dynamic_extent>>,
+        extents<size_t, 6, 3>>);
+
+    // Everything folds to constants.
+    constexpr E e(9);
+    constexpr auto cat = extents_cat(e, extents<size_t, 5>{}, dextents<size_t, 1>{6});
+    static_assert(cat.extent(1) == 9 && cat.extent(3) == 5 && cat.extent(4) == 6);
+    static_assert(extents_drop<0, 2>(e).extent(0) == 9);
+    static_assert(extents_insert<0, 7>(e).extent(2) == 9);
+    static_assert(extents_insert<3>(e, 11).extent(3) == 11);
+    static_assert(extents_merge(dextents<size_t, 3>{2, 9, 4}, e) == e);
+}
+
+TEST(extents_algebra_tests, runtime_shapes) {
+    const auto b = extents_broadcast(dextents<size_t, 3>{4, 1, 6}, extents<size_t, 5, 1>{});
+    static_assert(is_same_v<decltype(b), const extents<size_t, dynamic_extent, 5, dynamic_extent>>);
+    EXPECT_EQ(b.extent(0), 4u);
+    EXPECT_EQ(b.extent(1), 5u);
+    EXPECT_EQ(b.extent(2), 6u);
+
+    const auto m = extents_merge(dextents<size_t, 2>{3, 8}, extents<size_t, dynamic_extent, 8>{3});
+    static_assert(is_same_v<decltype(m), const extents<size_t, dynamic_extent, 8>>);
+    EXPECT_EQ(m.extent(0), 3u);
+
+    const auto d = extents_drop<1>(dextents<size_t, 3>{2, 3, 4});
+    EXPECT_EQ(d, (dextents<size_t, 2>{2, 4}));
+    const auto i = extents_insert<2>(d, 10);
+    EXPECT_EQ(i, (dextents<size_t, 3>{2, 4, 10}));
+}
+
+TEST(checked_accessor_tests, traits) {
+    using A = checked_accessor<default_accessor<int>>;
+    static_assert(!is_default_constructible_v<A>);
+    static_assert(is_same_v<A::offset_policy, A>);
+    static_assert(is_same_v<A::pointer, int*>);
+    static_assert(is_convertible_v<A, checked_accessor<default_accessor<const int>>>);
+    static_assert(!is_convertible_v<checked_accessor<default_accessor<const int>>, A>);
+
+    constexpr A acc(4);
+    static_assert(acc.storage_size() == 4);
+}
+
+TEST(checked_accessor_tests, bounds_checked) {
+    int data[12];
+    for (int i = 0; i < 12; ++i) {
+        data[i] = i;
+    }
+
+    mdspan<int, dextents<size_t, 2>> m(data, 3, 4);
+    const auto c = bounds_checked(m, 12);
+    static_assert(is_same_v<decltype(c)::accessor_type, checked_accessor<default_accessor<int>>>);
+    EXPECT_EQ(c(2, 3), 11);
+    EXPECT_EQ((c[array<size_t, 2>{1, 2}]), 6);
+    EXPECT_EQ(c.accessor().storage_size(), 12u);
+
+    mdspan<const int, dextents<size_t, 2>, layout_right, checked_accessor<default_accessor<const int>>> k = c;
+    EXPECT_EQ(k(1, 0), 4);
+
+    EXPECT_DEATH((void) c(0, 4), "");
+    EXPECT_DEATH((void) c(3, 0), "");
+    EXPECT_DEATH((void) bounds_checked(m, 11), "");
+}
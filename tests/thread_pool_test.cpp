@@ -0,0 +1,115 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "thread_pool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+TEST(thread_pool_tests, size) {
+    work_stealing_pool pool(3);
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.current_worker(), pool.size());
+
+    work_stealing_pool pinned(2, true);
+    EXPECT_EQ(pinned.size(), 2u);
+
+    work_stealing_pool automatic;
+    EXPECT_GE(automatic.size(), 1u);
+}
+
+TEST(thread_pool_tests, task_group) {
+    work_stealing_pool pool(4);
+    atomic<int> sum{0};
+    task_group group(pool);
+    for (int i = 1; i <= 100; ++i) {
+        group.run([&sum, i] { sum += i; });
+    }
+    group.wait();
+    EXPECT_EQ(sum.load(), 5050);
+}
+
+TEST(thread_pool_tests, nested_groups) {
+    work_stealing_pool pool(2);
+    atomic<int> count{0};
+    task_group outer(pool);
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&] {
+            task_group inner(pool);
+            for (int j = 0; j < 8; ++j) {
+                inner.run([&count] { ++count; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    EXPECT_EQ(count.load(), 64);
+}
+
+TEST(thread_pool_tests, exceptions) {
+    work_stealing_pool pool(2);
+    task_group group(pool);
+    atomic<int> ran{0};
+    for (int i = 0; i < 10; ++i) {
+        group.run([&ran, i] {
+            ++ran;
+            if (i == 3) {
+                throw runtime_error("task failed");
+            }
+        });
+    }
+    EXPECT_THROW(group.wait(), runtime_error);
+    EXPECT_EQ(ran.load(), 10);
+
+    // The error is reported once.
+    group.wait();
+}
+
+TEST(thread_pool_tests, parallel_for_tiles) {
+    work_stealing_pool pool(4);
+    using E = extents<size_t, dynamic_extent, 37>;
+    const E e{53};
+    vector<atomic<int>> hits(53 * 37);
+    atomic<int> tiles{0};
+
+    parallel_for_tiles(pool, e, array<size_t, 2>{8, 5}, [&](const array<size_t, 2>& lo, const array<size_t, 2>& hi) {
+        EXPECT_LE(hi[0] - lo[0], 8u);
+        EXPECT_LE(hi[1] - lo[1], 5u);
+        ++tiles;
+        for (size_t i = lo[0]; i < hi[0]; ++i) {
+            for (size_t j = lo[1]; j < hi[1]; ++j) {
+                ++hits[i * 37 + j];
+            }
+        }
+    });
+
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+    EXPECT_GE(tiles.load(), 7 * 8);
+}
+
+TEST(thread_pool_tests, triangular) {
+    // Only the lower triangle does work; stealing balances the uneven tiles.
+    work_stealing_pool pool(3);
+    constexpr size_t n = 200;
+    vector<double> data(n * n, 1.0);
+    mdspan<double, dextents<size_t, 2>> m(data.data(), n, n);
+
+    parallel_for_tiles(pool, m.extents(), array<size_t, 2>{16, 16}, [&](const array<size_t, 2>& lo, const array<size_t, 2>& hi) {
+        for (size_t i = lo[0]; i < hi[0]; ++i) {
+            for (size_t j = lo[1]; j < hi[1] && j <= i; ++j) {
+                m(i, j) = static_cast<double>(i + j);
+            }
+        }
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            EXPECT_EQ(m(i, j), j <= i ? static_cast<double>(i + j) : 1.0);
+        }
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#include <gtest/gtest.h>
+#include "tiles.h"
+#include <coroutine>
+#include <vector>
+
+using namespace std;
+
+using E = dextents<size_t, 2>;
+
+namespace {
+    // Runs a coroutine eagerly and leaves its frame to clean itself up.
+    struct detached {
+        struct promise_type {
+            detached get_return_object() noexcept {
+                return {};
+            }
+            suspend_never initial_suspend() noexcept {
+                return {};
+            }
+            suspend_never final_suspend() noexcept {
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() {
+                terminate();
+            }
+        };
+    };
+
+    template <class Span>
+    detached consume(md_async_generator<md_tile<Span>>& gen, vector<array<size_t, 2>>& seen, int& sum, bool& done) {
+        while (auto tile = co_await gen.next()) {
+            seen.push_back(tile->offset);
+            for (size_t i = 0; i < tile->view.extent(0); ++i) {
+                for (size_t j = 0; j < tile->view.extent(1); ++j) {
+                    sum += tile->view(i, j);
+                }
+            }
+        }
+        done = true;
+    }
+} // namespace
+
+TEST(tiles_tests, layout_right_order) {
+    vector<int> data(5 * 7);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i);
+    }
+    mdspan<int, E> m(data.data(), 5, 7);
+
+    vector<array<size_t, 2>> offsets;
+    int sum = 0;
+    for (const auto& tile : tiles(m, {2, 3})) {
+        offsets.push_back(tile.offset);
+        EXPECT_EQ(tile.view.extent(0), (min)(size_t{2}, 5 - tile.offset[0]));
+        EXPECT_EQ(tile.view.extent(1), (min)(size_t{3}, 7 - tile.offset[1]));
+        for (size_t i = 0; i < tile.view.extent(0); ++i) {
+            for (size_t j = 0; j < tile.view.extent(1); ++j) {
+                EXPECT_EQ(tile.view(i, j), m(tile.offset[0] + i, tile.offset[1] + j));
+                sum += tile.view(i, j);
+            }
+        }
+    }
+
+    const vector<array<size_t, 2>> expected{
+        {0, 0}, {0, 3}, {0, 6}, {2, 0}, {2, 3}, {2, 6}, {4, 0}, {4, 3}, {4, 6}};
+    EXPECT_EQ(offsets, expected);
+    EXPECT_EQ(sum, 34 * 35 / 2);
+}
+
+TEST(tiles_tests, layout_left_order) {
+    vector<int> data(4 * 4);
+    mdspan<int, E, layout_left> m(data.data(), 4, 4);
+
+    vector<array<size_t, 2>> offsets;
+    for (const auto& tile : tiles(m, {2, 2})) {
+        offsets.push_back(tile.offset);
+        tile.view(0, 0) = 1;
+    }
+
+    const vector<array<size_t, 2>> expected{{0, 0}, {2, 0}, {0, 2}, {2, 2}};
+    EXPECT_EQ(offsets, expected);
+    EXPECT_EQ(m(2, 2), 1);
+    EXPECT_EQ(m(1, 1), 0);
+}
+
+TEST(tiles_tests, checked_tiles) {
+    vector<int> data(5 * 7);
+    mdspan<int, E> m(data.data(), 5, 7);
+    const auto checked = bounds_checked(m, data.size());
+
+    // The last tile starts at offset 4 * 7 + 6, so one element of storage remains past its data handle.
+    size_t count = 0;
+    for (const auto& tile : tiles(checked, {2, 3})) {
+        if (++count < 9) {
+            continue;
+        }
+        EXPECT_EQ(tile.offset, (array<size_t, 2>{4, 6}));
+        EXPECT_EQ(tile.view.accessor().storage_size(), 1u);
+        tile.view(0, 0) = 5;
+        EXPECT_DEATH((void) tile.view.accessor().access(tile.view.data(), 1), "");
+    }
+    EXPECT_EQ(count, 9u);
+    EXPECT_EQ(data.back(), 5);
+}
+
+TEST(tiles_tests, empty) {
+    vector<int> data(1);
+    mdspan<int, E> m(data.data(), 0, 3);
+    size_t count = 0;
+    for (const auto& tile : tiles(m, {2, 2})) {
+        (void) tile;
+        ++count;
+    }
+    EXPECT_EQ(count, 0u);
+}
+
+TEST(tiles_tests, async_waits_for_arrival) {
+    vector<int> data(4 * 6, 1);
+    mdspan<int, E> m(data.data(), 4, 6);
+    arrival_counter arrivals;
+
+    auto gen = async_tiles(m, {2, 3}, arrivals);
+    vector<array<size_t, 2>> seen;
+    int sum = 0;
+    bool done = false;
+    consume(gen, seen, sum, done);
+    EXPECT_TRUE(seen.empty());
+
+    // The first tile ends at offset 1 * 6 + 2; the second at 1 * 6 + 5.
+    arrivals.arrive(8);
+    EXPECT_TRUE(seen.empty());
+    arrivals.arrive(1);
+    ASSERT_EQ(seen.size(), 1u);
+    arrivals.arrive(3);
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_FALSE(done);
+
+    arrivals.arrive(12);
+    const vector<array<size_t, 2>> expected{{0, 0}, {0, 3}, {2, 0}, {2, 3}};
+    EXPECT_EQ(seen, expected);
+    EXPECT_EQ(sum, 24);
+    EXPECT_TRUE(done);
+}
@@ -0,0 +1,500 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace std {
+    class task_group;
+
+    // The logical processors of each NUMA node that has any.
+    class numa_topology {
+    public:
+        numa_topology() : _Node_cpus(1) {
+            const size_t _Processors = (_STD max)(size_t{1}, static_cast<size_t>(thread::hardware_concurrency()));
+            for (size_t _Cpu = 0; _Cpu < _Processors; ++_Cpu) {
+                _Node_cpus[0].push_back(_Cpu);
+            }
+        }
+
+        explicit numa_topology(vector<vector<size_t>> _Node_cpus_) : _Node_cpus(_STD move(_Node_cpus_)) {
+            _STL_VERIFY(!_Node_cpus.empty(), "A NUMA topology needs at least one node.");
+            for (const auto& _Cpus : _Node_cpus) {
+                _STL_VERIFY(!_Cpus.empty(), "Every NUMA node in a topology needs at least one processor.");
+            }
+        }
+
+        // Queries the operating system, falling back to a single node with every processor.
+        _NODISCARD static numa_topology detect() {
+            vector<vector<size_t>> _Nodes;
+#if defined(_WIN32)
+            ULONG _Highest = 0;
+            if (::GetNumaHighestNodeNumber(&_Highest)) {
+                for (ULONG _Node = 0; _Node <= _Highest; ++_Node) {
+                    ULONGLONG _Mask = 0;
+                    vector<size_t> _Cpus;
+                    if (::GetNumaNodeProcessorMask(static_cast<UCHAR>(_Node), &_Mask)) {
+                        for (size_t _Cpu = 0; _Cpu < 64; ++_Cpu) {
+                            if (_Mask & (ULONGLONG{1} << _Cpu)) {
+                                _Cpus.push_back(_Cpu);
+                            }
+                        }
+                    }
+                    if (!_Cpus.empty()) {
+                        _Nodes.push_back(_STD move(_Cpus));
+                    }
+                }
+            }
+#elif defined(__linux__)
+            for (const size_t _Node : _Parse_cpu_list("/sys/devices/system/node/online")) {
+                auto _Cpus = _Parse_cpu_list("/sys/devices/system/node/node" + to_string(_Node) + "/cpulist");
+                if (!_Cpus.empty()) {
+                    _Nodes.push_back(_STD move(_Cpus));
+                }
+            }
+#endif
+            if (_Nodes.empty()) {
+                return numa_topology{};
+            }
+
+            return numa_topology{_STD move(_Nodes)};
+        }
+
+        _NODISCARD size_t node_count() const noexcept {
+            return _Node_cpus.size();
+        }
+
+        _NODISCARD const vector<size_t>& cpus(const size_t _Node) const noexcept {
+            return _Node_cpus[_Node];
+        }
+
+    private:
+        // Reads a list such as "0-3,8,10-11" from sysfs.
+        static vector<size_t> _Parse_cpu_list([[maybe_unused]] const string& _Path) {
+            vector<size_t> _Result;
+#ifdef __linux__
+            ifstream _File(_Path);
+            string _Text;
+            if (!_STD getline(_File, _Text)) {
+                return _Result;
+            }
+
+            size_t _Pos = 0;
+            while (_Pos < _Text.size()) {
+                size_t _End = _Text.find(',', _Pos);
+                if (_End == string::npos) {
+                    _End = _Text.size();
+                }
+
+                const string _Item = _Text.substr(_Pos, _End - _Pos);
+                const size_t _Dash = _Item.find('-');
+                try {
+                    const size_t _First = _STD stoul(_Item.substr(0, _Dash));
+                    const size_t _Last = _Dash == string::npos ? _First : _STD stoul(_Item.substr(_Dash + 1));
+                    for (size_t _Cpu = _First; _Cpu <= _Last; ++_Cpu) {
+                        _Result.push_back(_Cpu);
+                    }
+                }
+                catch (const logic_error&) {
+                    return {};
+                }
+
+                _Pos = _End + 1;
+            }
+#endif
+            return _Result;
+        }
+
+        vector<vector<size_t>> _Node_cpus;
+    };
+
+    // A fixed set of worker threads, each owning a deque of tasks. Workers run their own tasks LIFO, which keeps
+    // recursively split work cache-hot, and steal FIFO from the others when they run dry, which takes the largest
+    // remaining pieces first.
+    class work_stealing_pool {
+    public:
+        // _Threads == 0 means thread::hardware_concurrency(). If _Pin_threads, worker i is bound to logical
+        // processor i modulo the processor count.
+        explicit work_stealing_pool(size_t _Threads = 0, bool _Pin_threads = false) {
+            const size_t _Processors = (_STD max)(size_t{1}, static_cast<size_t>(thread::hardware_concurrency()));
+            vector<size_t> _Cpus((_STD max)(size_t{1}, _Threads == 0 ? _Processors : _Threads));
+            for (size_t _Idx = 0; _Idx < _Cpus.size(); ++_Idx) {
+                _Cpus[_Idx] = _Idx % _Processors;
+            }
+            _Start(_Cpus, vector<size_t>(_Cpus.size()), 1, _Pin_threads);
+        }
+
+        // One worker per processor of _Topology, numbered node by node. Tasks run with run_on_node stay on the
+        // workers of that node, so work can follow the placement of the memory it touches.
+        explicit work_stealing_pool(const numa_topology& _Topology, bool _Pin_threads = true) {
+            vector<size_t> _Cpus;
+            vector<size_t> _Nodes;
+            for (size_t _Node = 0; _Node < _Topology.node_count(); ++_Node) {
+                for (const size_t _Cpu : _Topology.cpus(_Node)) {
+                    _Cpus.push_back(_Cpu);
+                    _Nodes.push_back(_Node);
+                }
+            }
+            _Start(_Cpus, _Nodes, _Topology.node_count(), _Pin_threads);
+        }
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        ~work_stealing_pool() {
+            {
+                lock_guard<mutex> _Lock(_Sleep_mtx);
+                _Stopping = true;
+            }
+            for (auto& _Node : _Node_states) {
+                _Node->_Wake.notify_all();
+            }
+            for (auto& _Thread : _Threads) {
+                _Thread.join();
+            }
+        }
+
+        _NODISCARD size_t size() const noexcept {
+            return _Queues.size();
+        }
+
+        // Index of the calling thread among this pool's workers, or size() if it is not one of them.
+        _NODISCARD size_t current_worker() const noexcept {
+            return _Current_pool == this ? _Current_index : size();
+        }
+
+        _NODISCARD size_t node_count() const noexcept {
+            return _Node_workers.size();
+        }
+
+        _NODISCARD size_t node_of(const size_t _Worker) const noexcept {
+            return _Worker_node[_Worker];
+        }
+
+        _NODISCARD const vector<size_t>& workers_on(const size_t _Node) const noexcept {
+            return _Node_workers[_Node];
+        }
+
+        static constexpr size_t any_node = static_cast<size_t>(-1);
+
+    private:
+        friend task_group;
+
+        struct _Task {
+            function<void()> _Func;
+            task_group* _Group;
+            size_t _Node; // any_node, or the only node whose workers may run the task
+        };
+
+        struct alignas(64) _Worker_queue {
+            mutex _Mtx;
+            deque<_Task> _Tasks;
+        };
+
+        // Sleeping workers of a node wait on _Wake until a task they may run is queued: one bound to the node
+        // (counted in _Queued) or one for any node (counted in the pool's _Queued_any).
+        struct alignas(64) _Node_state {
+            atomic<size_t> _Queued{0};
+            condition_variable _Wake;
+        };
+
+        void _Start(const vector<size_t>& _Cpus, const vector<size_t>& _Nodes, const size_t _Node_count,
+            const bool _Pin_threads) {
+            _Worker_node = _Nodes;
+            _Node_workers.resize(_Node_count);
+            _Node_states.reserve(_Node_count);
+            for (size_t _Node = 0; _Node < _Node_count; ++_Node) {
+                _Node_states.push_back(make_unique<_Node_state>());
+            }
+            for (size_t _Idx = 0; _Idx < _Nodes.size(); ++_Idx) {
+                _Node_workers[_Nodes[_Idx]].push_back(_Idx);
+            }
+
+            _Queues.reserve(_Cpus.size());
+            for (size_t _Idx = 0; _Idx < _Cpus.size(); ++_Idx) {
+                _Queues.push_back(make_unique<_Worker_queue>());
+            }
+
+            _Threads.reserve(_Cpus.size());
+            for (size_t _Idx = 0; _Idx < _Cpus.size(); ++_Idx) {
+                _Threads.emplace_back([this, _Idx] { _Worker_main(_Idx); });
+                if (_Pin_threads) {
+                    _Pin(_Threads.back(), _Cpus[_Idx]);
+                }
+            }
+        }
+
+        static void _Pin([[maybe_unused]] thread& _Thread, [[maybe_unused]] const size_t _Cpu) noexcept {
+#if defined(_WIN32)
+            if (_Cpu < sizeof(DWORD_PTR) * 8) {
+                ::SetThreadAffinityMask(_Thread.native_handle(), DWORD_PTR{1} << _Cpu);
+            }
+#elif defined(__linux__)
+            if (_Cpu < CPU_SETSIZE) {
+                cpu_set_t _Set;
+                CPU_ZERO(&_Set);
+                CPU_SET(_Cpu, &_Set);
+                (void) ::pthread_setaffinity_np(_Thread.native_handle(), sizeof(_Set), &_Set);
+            }
+#endif
+        }
+
+        void _Push(_Task&& _New) {
+            const size_t _Node = _New._Node;
+            size_t _Target = current_worker();
+            if (_Node != any_node) {
+                if (_Target == size() || _Worker_node[_Target] != _Node) {
+                    const auto& _Members = _Node_workers[_Node];
+                    _Target = _Members[_Next_external.fetch_add(1, memory_order_relaxed) % _Members.size()];
+                }
+            }
+            else if (_Target == size()) {
+                _Target = _Next_external.fetch_add(1, memory_order_relaxed) % size();
+            }
+
+            {
+                lock_guard<mutex> _Lock(_Queues[_Target]->_Mtx);
+                _Queues[_Target]->_Tasks.push_back(_STD move(_New));
+            }
+
+            _Queued_counter(_Node).fetch_add(1, memory_order_release);
+            {
+                lock_guard<mutex> _Lock(_Sleep_mtx);
+            }
+            // Wake a worker of the node that may run the task, which for an unbound task is the target's.
+            _Node_states[_Worker_node[_Target]]->_Wake.notify_one();
+        }
+
+        _NODISCARD atomic<size_t>& _Queued_counter(const size_t _Node) noexcept {
+            return _Node == any_node ? _Queued_any : _Node_states[_Node]->_Queued;
+        }
+
+        _NODISCARD bool _Has_work_for(const size_t _Node) const noexcept {
+            return _Queued_any.load(memory_order_acquire) != 0
+                || _Node_states[_Node]->_Queued.load(memory_order_acquire) != 0;
+        }
+
+        bool _Try_pop(const size_t _Self, _Task& _Out) {
+            if (_Self < size()) {
+                auto& _Own = *_Queues[_Self];
+                lock_guard<mutex> _Lock(_Own._Mtx);
+                if (!_Own._Tasks.empty()) {
+                    _Out = _STD move(_Own._Tasks.back());
+                    _Own._Tasks.pop_back();
+                    return true;
+                }
+            }
+
+            // Steal from the same node first. Tasks bound to a node are only taken by that node's workers.
+            const size_t _My_node = _Self < size() ? _Worker_node[_Self] : any_node;
+            const size_t _Start_at = _Self < size() ? _Self + 1 : 0;
+            for (const bool _Local_pass : {true, false}) {
+                for (size_t _Count = 0; _Count < size(); ++_Count) {
+                    const size_t _Victim = (_Start_at + _Count) % size();
+                    if (_Victim == _Self || (_Worker_node[_Victim] == _My_node) != _Local_pass) {
+                        continue;
+                    }
+
+                    auto& _Other = *_Queues[_Victim];
+                    lock_guard<mutex> _Lock(_Other._Mtx);
+                    const auto _Found = _STD find_if(_Other._Tasks.begin(), _Other._Tasks.end(),
+                        [_My_node](const _Task& _Candidate) {
+                            return _Candidate._Node == any_node || _Candidate._Node == _My_node;
+                        });
+                    if (_Found != _Other._Tasks.end()) {
+                        _Out = _STD move(*_Found);
+                        _Other._Tasks.erase(_Found);
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        // Runs one queued task, if there is one, on the calling thread.
+        bool _Try_run_one();
+
+        void _Worker_main(const size_t _Idx) {
+            _Current_pool = this;
+            _Current_index = _Idx;
+            const size_t _Node = _Worker_node[_Idx];
+            for (;;) {
+                if (_Try_run_one()) {
+                    continue;
+                }
+
+                unique_lock<mutex> _Lock(_Sleep_mtx);
+                _Node_states[_Node]->_Wake.wait(_Lock, [this, _Node] { return _Stopping || _Has_work_for(_Node); });
+                if (_Stopping && !_Has_work_for(_Node)) {
+                    return;
+                }
+            }
+        }
+
+        vector<unique_ptr<_Worker_queue>> _Queues;
+        vector<thread> _Threads;
+        vector<size_t> _Worker_node;
+        vector<vector<size_t>> _Node_workers;
+        vector<unique_ptr<_Node_state>> _Node_states;
+        atomic<size_t> _Queued_any{0};
+        atomic<size_t> _Next_external{0};
+        mutex _Sleep_mtx;
+        bool _Stopping = false;
+
+        static inline thread_local const work_stealing_pool* _Current_pool = nullptr;
+        static inline thread_local size_t _Current_index = 0;
+    };
+
+    // A set of tasks run on a work_stealing_pool that can be waited for together. The waiting thread executes
+    // queued tasks until the group is done, so groups may be nested inside tasks without deadlock.
+    class task_group {
+    public:
+        explicit task_group(work_stealing_pool& _Pool_) noexcept : _Pool(_Pool_) {}
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        ~task_group() {
+            _Wait_done();
+        }
+
+        template <class _Fn>
+        void run(_Fn&& _Func) {
+            run_on_node(work_stealing_pool::any_node, _STD forward<_Fn>(_Func));
+        }
+
+        // Runs _Func on a worker of _Node, or on any worker if _Node is work_stealing_pool::any_node.
+        template <class _Fn>
+        void run_on_node(const size_t _Node, _Fn&& _Func) {
+            _STL_VERIFY(_Node == work_stealing_pool::any_node || _Node < _Pool.node_count(), "NUMA node out of range.");
+            _Pending.fetch_add(1, memory_order_relaxed);
+            _Pool._Push({function<void()>(_STD forward<_Fn>(_Func)), this, _Node});
+        }
+
+        // Waits for every task run so far and rethrows the first exception any of them threw.
+        void wait() {
+            _Wait_done();
+            if (_Error) {
+                auto _Thrown = _STD exchange(_Error, nullptr);
+                _STD rethrow_exception(_Thrown);
+            }
+        }
+
+    private:
+        friend work_stealing_pool;
+
+        void _Wait_done() noexcept {
+            while (_Pending.load(memory_order_acquire) != 0) {
+                if (!_Pool._Try_run_one()) {
+                    this_thread::yield();
+                }
+            }
+        }
+
+        void _Execute(function<void()>& _Func) noexcept {
+            try {
+                _Func();
+            }
+            catch (...) {
+                lock_guard<mutex> _Lock(_Error_mtx);
+                if (!_Error) {
+                    _Error = _STD current_exception();
+                }
+            }
+
+            _Pending.fetch_sub(1, memory_order_release);
+        }
+
+        work_stealing_pool& _Pool;
+        atomic<size_t> _Pending{0};
+        mutex _Error_mtx;
+        exception_ptr _Error;
+    };
+
+    inline bool work_stealing_pool::_Try_run_one() {
+        _Task _Next;
+        if (!_Try_pop(current_worker(), _Next)) {
+            return false;
+        }
+
+        _Queued_counter(_Next._Node).fetch_sub(1, memory_order_relaxed);
+        _Next._Group->_Execute(_Next._Func);
+        return true;
+    }
+
+    // Splits [_Lo, _Hi) in half along the dimension that exceeds its grain by the largest factor, queuing one half
+    // and continuing with the other, until every piece is within _Grain. The queued halves are bound to _Node.
+    template <size_t _Rank, class _Fn>
+    void _Parallel_for_box(task_group& _Group, array<size_t, _Rank> _Lo, array<size_t, _Rank> _Hi,
+        const array<size_t, _Rank>& _Grain, const _Fn& _Func, const size_t _Node = work_stealing_pool::any_node) {
+        for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+            if (_Lo[_Dim] >= _Hi[_Dim]) {
+                return;
+            }
+        }
+
+        for (;;) {
+            size_t _Split = _Rank;
+            size_t _Split_len = 1;
+            size_t _Split_grain = 1;
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                const size_t _Len = _Hi[_Dim] - _Lo[_Dim];
+                const size_t _Dim_grain = (_STD max)(size_t{1}, _Grain[_Dim]);
+                if (_Len > _Dim_grain && _Len * _Split_grain > _Split_len * _Dim_grain) {
+                    _Split = _Dim;
+                    _Split_len = _Len;
+                    _Split_grain = _Dim_grain;
+                }
+            }
+
+            if (_Split == _Rank) {
+                _Func(_STD as_const(_Lo), _STD as_const(_Hi));
+                return;
+            }
+
+            array<size_t, _Rank> _Upper_lo = _Lo;
+            _Upper_lo[_Split] = _Lo[_Split] + (_Hi[_Split] - _Lo[_Split]) / 2;
+            _Group.run_on_node(_Node, [&_Group, _Upper_lo, _Hi, &_Grain, &_Func, _Node] {
+                _Parallel_for_box(_Group, _Upper_lo, _Hi, _Grain, _Func, _Node);
+            });
+            _Hi[_Split] = _Upper_lo[_Split];
+        }
+    }
+
+    // Calls _Func(lo, hi) on _Pool for tiles [lo, hi) covering the index space of _Ext, each at most _Grain in
+    // every dimension. Tiles are produced by recursive bisection and load-balanced by stealing, so _Func may
+    // take very different times for different tiles (masked or triangular regions).
+    template <class _Extents, class _Fn>
+    void parallel_for_tiles(
+        work_stealing_pool& _Pool, const _Extents& _Ext, const array<size_t, _Extents::rank()>& _Grain, _Fn _Func) {
+        array<size_t, _Extents::rank()> _Lo{};
+        array<size_t, _Extents::rank()> _Hi{};
+        for (size_t _Dim = 0; _Dim < _Extents::rank(); ++_Dim) {
+            _Hi[_Dim] = _Ext.extent(_Dim);
+        }
+
+        task_group _Group(_Pool);
+        _Parallel_for_box(_Group, _Lo, _Hi, _Grain, _Func);
+        _Group.wait();
+    }
+} // namespace std
@@ -0,0 +1,421 @@
+// Copyright(c) Matt Stephanson.
+// SPDX - License - Identifier: Apache - 2.0 WITH LLVM - exception
+
+#pragma once
+
+#include "mdspan.h"
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace std {
+    // A lazily produced sequence: the coroutine runs up to each co_yield as the range is iterated.
+    template <class _Ty>
+    class md_generator {
+    public:
+        struct promise_type {
+            optional<_Ty> _Value;
+            exception_ptr _Error;
+
+            _NODISCARD md_generator get_return_object() noexcept {
+                return md_generator{coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            suspend_always final_suspend() noexcept {
+                return {};
+            }
+
+            suspend_always yield_value(_Ty _Val) noexcept(is_nothrow_move_constructible_v<_Ty>) {
+                _Value.emplace(_STD move(_Val));
+                return {};
+            }
+
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept {
+                _Error = _STD current_exception();
+            }
+
+            // Synchronous generators can't wait; use md_async_generator.
+            template <class _Awaitable>
+            void await_transform(_Awaitable&&) = delete;
+        };
+
+        class iterator {
+        public:
+            using value_type = _Ty;
+            using difference_type = ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            explicit iterator(const coroutine_handle<promise_type> _Handle_) noexcept : _Handle(_Handle_) {}
+
+            _NODISCARD const _Ty& operator*() const noexcept {
+                return *_Handle.promise()._Value;
+            }
+
+            _NODISCARD const _Ty* operator->() const noexcept {
+                return &*_Handle.promise()._Value;
+            }
+
+            iterator& operator++() {
+                _Resume(_Handle);
+                return *this;
+            }
+
+            void operator++(int) {
+                ++*this;
+            }
+
+            _NODISCARD friend bool operator==(const iterator& _It, default_sentinel_t) noexcept {
+                return !_It._Handle || _It._Handle.done();
+            }
+
+        private:
+            coroutine_handle<promise_type> _Handle;
+        };
+
+        md_generator(md_generator&& _Other) noexcept : _Handle(_STD exchange(_Other._Handle, nullptr)) {}
+
+        md_generator& operator=(md_generator&& _Other) noexcept {
+            if (this != &_Other) {
+                if (_Handle) {
+                    _Handle.destroy();
+                }
+                _Handle = _STD exchange(_Other._Handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~md_generator() {
+            if (_Handle) {
+                _Handle.destroy();
+            }
+        }
+
+        // Starts the coroutine; a generator can be iterated once.
+        _NODISCARD iterator begin() {
+            _Resume(_Handle);
+            return iterator{_Handle};
+        }
+
+        _NODISCARD default_sentinel_t end() const noexcept {
+            return default_sentinel;
+        }
+
+    private:
+        explicit md_generator(const coroutine_handle<promise_type> _Handle_) noexcept : _Handle(_Handle_) {}
+
+        static void _Resume(const coroutine_handle<promise_type> _Handle) {
+            auto& _Promise = _Handle.promise();
+            _Promise._Value.reset();
+            _Handle.resume();
+            if (_Promise._Error) {
+                _STD rethrow_exception(_STD exchange(_Promise._Error, nullptr));
+            }
+        }
+
+        coroutine_handle<promise_type> _Handle;
+    };
+
+    // A sequence whose coroutine may co_await between values. Consumers write co_await gen.next() from their own
+    // coroutine, which yields an empty optional at the end. Control passes directly between consumer and producer;
+    // when the producer waits on something, the consumer stays suspended until whatever resumes the producer
+    // reaches the next co_yield.
+    template <class _Ty>
+    class md_async_generator {
+    public:
+        struct promise_type {
+            optional<_Ty> _Value;
+            exception_ptr _Error;
+            coroutine_handle<> _Consumer;
+
+            struct _Transfer {
+                _NODISCARD bool await_ready() const noexcept {
+                    return false;
+                }
+
+                _NODISCARD coroutine_handle<> await_suspend(const coroutine_handle<promise_type> _Self) noexcept {
+                    return _Self.promise()._Consumer;
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            _NODISCARD md_async_generator get_return_object() noexcept {
+                return md_async_generator{coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            _Transfer final_suspend() noexcept {
+                return {};
+            }
+
+            _Transfer yield_value(_Ty _Val) noexcept(is_nothrow_move_constructible_v<_Ty>) {
+                _Value.emplace(_STD move(_Val));
+                return {};
+            }
+
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept {
+                _Error = _STD current_exception();
+            }
+        };
+
+        class _Next_awaiter {
+        public:
+            explicit _Next_awaiter(const coroutine_handle<promise_type> _Handle_) noexcept : _Handle(_Handle_) {}
+
+            _NODISCARD bool await_ready() const noexcept {
+                return !_Handle || _Handle.done();
+            }
+
+            _NODISCARD coroutine_handle<> await_suspend(const coroutine_handle<> _Consumer) noexcept {
+                auto& _Promise = _Handle.promise();
+                _Promise._Consumer = _Consumer;
+                _Promise._Value.reset();
+                return _Handle;
+            }
+
+            _NODISCARD optional<_Ty> await_resume() {
+                if (!_Handle) {
+                    return nullopt;
+                }
+
+                auto& _Promise = _Handle.promise();
+                if (_Promise._Error) {
+                    _STD rethrow_exception(_STD exchange(_Promise._Error, nullptr));
+                }
+                return _STD exchange(_Promise._Value, nullopt);
+            }
+
+        private:
+            coroutine_handle<promise_type> _Handle;
+        };
+
+        md_async_generator(md_async_generator&& _Other) noexcept : _Handle(_STD exchange(_Other._Handle, nullptr)) {}
+
+        md_async_generator& operator=(md_async_generator&& _Other) noexcept {
+            if (this != &_Other) {
+                if (_Handle) {
+                    _Handle.destroy();
+                }
+                _Handle = _STD exchange(_Other._Handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~md_async_generator() {
+            if (_Handle) {
+                _Handle.destroy();
+            }
+        }
+
+        _NODISCARD _Next_awaiter next() noexcept {
+            return _Next_awaiter{_Handle};
+        }
+
+    private:
+        explicit md_async_generator(const coroutine_handle<promise_type> _Handle_) noexcept : _Handle(_Handle_) {}
+
+        coroutine_handle<promise_type> _Handle;
+    };
+
+    // Counts elements of a buffer that have arrived, in offset order, as a file reader or socket would fill it.
+    // Coroutines co_await wait_for(n) to be resumed once the first n elements are present; they resume on the
+    // thread that calls arrive().
+    class arrival_counter {
+    public:
+        class _Awaiter {
+        public:
+            _Awaiter(arrival_counter& _Counter_, const size_t _Target_) noexcept
+                : _Counter(_Counter_), _Target(_Target_) {}
+
+            _NODISCARD bool await_ready() const {
+                return _Counter.arrived() >= _Target;
+            }
+
+            _NODISCARD bool await_suspend(const coroutine_handle<> _Waiter) {
+                lock_guard _Lock(_Counter._Mutex);
+                if (_Counter._Arrived >= _Target) {
+                    return false;
+                }
+                _Counter._Waiters.push_back({_Target, _Waiter});
+                return true;
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            arrival_counter& _Counter;
+            size_t _Target;
+        };
+
+        arrival_counter() = default;
+        arrival_counter(const arrival_counter&) = delete;
+        arrival_counter& operator=(const arrival_counter&) = delete;
+
+        _NODISCARD size_t arrived() const {
+            lock_guard _Lock(_Mutex);
+            return _Arrived;
+        }
+
+        // Records _Count more elements and resumes the coroutines they satisfy.
+        void arrive(const size_t _Count) {
+            vector<coroutine_handle<>> _Ready;
+            {
+                lock_guard _Lock(_Mutex);
+                _Arrived += _Count;
+                auto _Keep = _Waiters.begin();
+                for (auto& _Waiter : _Waiters) {
+                    if (_Waiter._Target <= _Arrived) {
+                        _Ready.push_back(_Waiter._Handle);
+                    } else {
+                        *_Keep++ = _Waiter;
+                    }
+                }
+                _Waiters.erase(_Keep, _Waiters.end());
+            }
+
+            for (const auto _Handle : _Ready) {
+                _Handle.resume();
+            }
+        }
+
+        _NODISCARD _Awaiter wait_for(const size_t _Target) noexcept {
+            return {*this, _Target};
+        }
+
+    private:
+        struct _Waiter_t {
+            size_t _Target;
+            coroutine_handle<> _Handle;
+        };
+
+        mutable mutex _Mutex;
+        size_t _Arrived = 0;
+        vector<_Waiter_t> _Waiters;
+    };
+
+    // One tile of a strided mdspan: its first index in the whole span, and a view of just the tile.
+    template <class _Span>
+    struct md_tile {
+        using view_type = mdspan<typename _Span::element_type, dextents<size_t, _Span::rank()>, layout_stride,
+            typename _Span::accessor_type::offset_policy>;
+
+        array<size_t, _Span::rank()> offset;
+        view_type view;
+    };
+
+    // The tile grid of a strided mdspan, walked with the largest-stride dimension outermost.
+    template <class _Span>
+    class _Tile_grid {
+    public:
+        static_assert(_Span::rank() > 0, "Tiling needs a rank of at least 1.");
+        static_assert(_Span::is_always_strided(), "Tiling requires a strided layout.");
+
+        static constexpr size_t _Rank = _Span::rank();
+
+        _Tile_grid(const _Span& _View_, const array<size_t, _Rank>& _Shape_) : _View(_View_), _Shape(_Shape_) {
+            for (size_t _Dim = 0; _Dim < _Rank; ++_Dim) {
+                _STL_VERIFY(_Shape[_Dim] > 0, "Tile extents must be positive.");
+                _Order[_Dim] = _Dim;
+                if (_View.extent(_Dim) == 0) {
+                    _Finished = true;
+                }
+            }
+            const auto _Map = _View.mapping();
+            _STD stable_sort(_Order.begin(), _Order.end(),
+                [&_Map](const size_t _Left, const size_t _Right) { return _Map.stride(_Left) > _Map.stride(_Right); });
+        }
+
+        _NODISCARD bool _Done() const noexcept {
+            return _Finished;
+        }
+
+        _NODISCARD md_tile<_Span> _Current() const {
+            return _Make(make_index_sequence<_Rank>{});
+        }
+
+        // One past the largest offset the current tile touches.
+        _NODISCARD size_t _Current_span() const {
+            return _Last_offset(make_index_sequence<_Rank>{}) + 1;
+        }
+
+        void _Advance() {
+            for (size_t _Level = _Rank; _Level > 0; --_Level) {
+                const size_t _Dim = _Order[_Level - 1];
+                _Lo[_Dim] += _Shape[_Dim];
+                if (_Lo[_Dim] < _View.extent(_Dim)) {
+                    return;
+                }
+                _Lo[_Dim] = 0;
+            }
+            _Finished = true;
+        }
+
+    private:
+        _NODISCARD size_t _Hi(const size_t _Dim) const {
+            return (_STD min)(_Lo[_Dim] + _Shape[_Dim], static_cast<size_t>(_View.extent(_Dim)));
+        }
+
+        template <size_t... _Seq>
+        _NODISCARD md_tile<_Span> _Make(index_sequence<_Seq...>) const {
+            using _Tile_extents = dextents<size_t, _Rank>;
+            const auto _Map = _View.mapping();
+            const auto _Acc = _View.accessor();
+            const layout_stride::mapping<_Tile_extents> _Tile_map{
+                _Tile_extents{(_Hi(_Seq) - _Lo[_Seq])...}, array<size_t, _Rank>{_Map.stride(_Seq)...}};
+            const auto _Offset = static_cast<size_t>(_Map(_Lo[_Seq]...));
+            return {_Lo, typename md_tile<_Span>::view_type{
+                             _Acc.offset(_View.data(), _Offset), _Tile_map, _Offset_accessor(_Acc, _Offset)}};
+        }
+
+        template <size_t... _Seq>
+        _NODISCARD size_t _Last_offset(index_sequence<_Seq...>) const {
+            return static_cast<size_t>(_View.mapping()((_Hi(_Seq) - 1)...));
+        }
+
+        _Span _View;
+        array<size_t, _Rank> _Shape;
+        array<size_t, _Rank> _Order{};
+        array<size_t, _Rank> _Lo{};
+        bool _Finished = false;
+    };
+
+    // Yields the tiles of _View with extents _Shape, smaller at the edges, in layout order.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    md_generator<md_tile<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>>> tiles(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy> _View,
+        const array<size_t, _Extents::rank()> _Shape) {
+        _Tile_grid<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>> _Grid{_View, _Shape};
+        for (; !_Grid._Done(); _Grid._Advance()) {
+            co_yield _Grid._Current();
+        }
+    }
+
+    // Like tiles, but waits before each tile until _Arrivals covers every offset the tile touches. With an
+    // exhaustive layout filled in offset order, tiles become available as the data streams in.
+    template <class _ElementType, class _Extents, class _LayoutPolicy, class _AccessorPolicy>
+    md_async_generator<md_tile<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>>> async_tiles(
+        const mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy> _View,
+        const array<size_t, _Extents::rank()> _Shape, arrival_counter& _Arrivals) {
+        _Tile_grid<mdspan<_ElementType, _Extents, _LayoutPolicy, _AccessorPolicy>> _Grid{_View, _Shape};
+        for (; !_Grid._Done(); _Grid._Advance()) {
+            co_await _Arrivals.wait_for(_Grid._Current_span());
+            co_yield _Grid._Current();
+        }
+    }
+} // namespace std